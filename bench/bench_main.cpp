@@ -0,0 +1,378 @@
+// Headless benchmarks for the simulation library. Runs without a window or audio device.
+//   findtreasure_bench [--bats N] [--max-platforms N] [--quick] [--json file] [--csv file]
+// Every benchmark is seeded, so results differ between builds only by speed.
+#include "level_file.h"
+#include "parallel.h"
+#include "rewind_buffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// One measurement, e.g. {"step_collision", "platforms", 10000, 2.5e6, "ticks/s"}
+struct BenchResult {
+    std::string name;
+    std::string parameter; // What count varies ("" if nothing does)
+    long count;
+    double value;
+    std::string unit;
+};
+
+static std::vector<BenchResult> results;
+static int benchRepeats = 10;
+
+static void Report(const std::string& name, const std::string& parameter, long count, double value,
+                   const std::string& unit) {
+    results.push_back({name, parameter, count, value, unit});
+    std::string label = parameter.empty() ? "" : parameter + "=" + std::to_string(count);
+    printf("%-22s %-18s %14.6g %s\n", name.c_str(), label.c_str(), value, unit.c_str());
+}
+
+// Best-of-N wall time of fn() in milliseconds
+template <typename Fn>
+static double MeasureBestMs(int repeats, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// Held buttons that change every few ticks, like a player running and jumping around
+static std::vector<uint8_t> MakeInputScript(int ticks, uint64_t seed) {
+    std::vector<uint8_t> script(ticks);
+    Rng rng;
+    SeedRng(rng, seed);
+    uint8_t buttons = INPUT_RIGHT;
+    for (int t = 0; t < ticks; t++) {
+        if (RandomInt(rng, 0, 15) == 0) buttons = static_cast<uint8_t>(RandomInt(rng, 0, 15));
+        script[t] = buttons;
+    }
+    return script;
+}
+
+// Run the script through Step. Reaching the flag puts the player back at the
+// start instead of copying the whole level, which would dominate large levels.
+static void RunScript(GameState& state, const GameState& initial, const std::vector<uint8_t>& script) {
+    for (uint8_t buttons : script) {
+        if (state.levelComplete) {
+            state.player = initial.player;
+            state.flag = initial.flag;
+            state.levelComplete = false;
+        }
+        Step(state, {buttons});
+    }
+}
+
+// Whole Step (movement, collision, bats, flag) on the default level
+static void BenchStep() {
+    GameState initial;
+    InitGame(initial, 1234, defaultPlayerSpriteSize, defaultBatFrameSize);
+    std::vector<uint8_t> script = MakeInputScript(20000, 99);
+    GameState state = initial;
+    double ms = MeasureBestMs(benchRepeats, [&] { RunScript(state, initial, script); });
+    Report("step", "", 0, script.size() / (ms / 1000.0), "ticks/s");
+}
+
+// Step on a one-screen level padded with platformCount one-tile ledges on a
+// staggered lattice that starts at the screen's top-left corner and extends far
+// past it. Only the ledges near the player should cost anything.
+static void BenchStepCollision(int platformCount) {
+    GameState initial;
+    InitGame(initial, 1234, defaultPlayerSpriteSize, defaultBatFrameSize, 1);
+    int columns = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(platformCount))));
+    for (int i = 0; i < platformCount; i++) {
+        int column = i % columns, row = i / columns;
+        float x = static_cast<float>((column * 3 + (row % 2)) * tileSize);
+        float y = static_cast<float>(row * 3 * tileSize);
+        initial.platforms.push_back({{x, y, static_cast<float>(tileSize), static_cast<float>(tileSize)}});
+    }
+    double buildMs = MeasureBestMs(3, [&] { BuildPlatformGrid(initial.platformGrid, initial.platforms); });
+
+    std::vector<uint8_t> script = MakeInputScript(10000, 7);
+    GameState state = initial;
+    double ms = MeasureBestMs(benchRepeats, [&] { RunScript(state, initial, script); });
+    Report("step_collision", "platforms", platformCount, script.size() / (ms / 1000.0), "ticks/s");
+    Report("platform_grid_build", "platforms", platformCount, buildMs, "ms");
+}
+
+// Movement, bounce and animation for a swarm spread over the whole screen
+static void BenchBatSwarm(int batCount) {
+    BatSwarm swarm;
+    InitBatSwarm(swarm, defaultBatFrameSize, batScale);
+    Rng rng;
+    SeedRng(rng, 1234);
+    for (int i = 0; i < batCount; i++) {
+        Vector2 position = {static_cast<float>(RandomInt(rng, 0, screenWidth - 101)),
+                            static_cast<float>(RandomInt(rng, 0, screenHeight - 79))};
+        Vector2 velocity = {RandomInt(rng, 0, 1) ? batSpeed : -batSpeed,
+                            RandomInt(rng, 0, 1) ? batSpeed : -batSpeed};
+        AddBat(swarm, position, velocity);
+    }
+    Rectangle area = {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)};
+
+    const int ticksPerRun = 100;
+    double ms = MeasureBestMs(benchRepeats, [&] {
+        for (int t = 0; t < ticksPerRun; t++) UpdateBatSwarm(swarm, area);
+    }) / ticksPerRun;
+    Report("bat_swarm_update", "bats", batCount, ms * 1e6 / batCount, "ns/bat");
+}
+
+// Same strict test as CheckCollisionRecs (and the sweep)
+static bool RectsOverlap(Rectangle a, Rectangle b) {
+    return a.x < b.x + b.width && a.x + a.width > b.x && a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+// Bats moving over the screen against four players, enemy pairs included:
+// the incremental sort-and-sweep against testing every pair
+static void BenchContactSweep(int batCount) {
+    BatSwarm swarm;
+    InitBatSwarm(swarm, defaultBatFrameSize, batScale);
+    Rng rng;
+    SeedRng(rng, 77);
+    for (int i = 0; i < batCount; i++) {
+        Vector2 position = {static_cast<float>(RandomInt(rng, 0, screenWidth - 101)),
+                            static_cast<float>(RandomInt(rng, 0, screenHeight - 79))};
+        Vector2 velocity = {RandomInt(rng, 0, 1) ? batSpeed : -batSpeed,
+                            RandomInt(rng, 0, 1) ? batSpeed : -batSpeed};
+        AddBat(swarm, position, velocity);
+    }
+    Rectangle area = {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)};
+    ContactSweep sweep;
+    InitContactSweep(sweep, true);
+    sweep.players = {{100, 500, 75, 59}, {400, 500, 75, 59}, {700, 300, 75, 59}, {1000, 500, 75, 59}};
+
+    const int ticksPerRun = 100;
+    long contacts = 0;
+    double sweepMs = MeasureBestMs(benchRepeats, [&] {
+        for (int t = 0; t < ticksPerRun; t++) {
+            UpdateBatSwarm(swarm, area);
+            sweep.enemies.resize(swarm.count);
+            for (int i = 0; i < swarm.count; i++) sweep.enemies[i] = GetBatBounds(swarm, i);
+            UpdateContactSweep(sweep);
+            contacts += sweep.playerContacts.size() + sweep.enemyContacts.size();
+        }
+    }) / ticksPerRun;
+    double bruteMs = MeasureBestMs(benchRepeats, [&] {
+        for (int t = 0; t < ticksPerRun; t++) {
+            UpdateBatSwarm(swarm, area);
+            for (int i = 0; i < swarm.count; i++) {
+                Rectangle bounds = GetBatBounds(swarm, i);
+                for (const Rectangle& player : sweep.players) contacts += RectsOverlap(bounds, player);
+                for (int j = i + 1; j < swarm.count; j++) contacts += RectsOverlap(bounds, GetBatBounds(swarm, j));
+            }
+        }
+    }) / ticksPerRun;
+    if (contacts < 0) printf("\n"); // Keeps the loops from being optimized out
+    Report("contact_sweep", "bats", batCount, sweepMs * 1000.0, "us/tick");
+    Report("contact_all_pairs", "bats", batCount, bruteMs * 1000.0, "us/tick");
+}
+
+// GenerateLevel on one thread, GenerateLevels on every core, AnalyzeLevel,
+// switching levels from a level file, and InitGame (level generation plus
+// streaming in the first chunks and their grid)
+static void BenchLevelGeneration() {
+    const int levels = 2000;
+    LevelSettings settings = DefaultLevelSettings(defaultLevelChunks);
+    LevelValidator validator;
+    Level level;
+    double ms = MeasureBestMs(benchRepeats, [&] {
+        for (int i = 0; i < levels; i++) GenerateLevel(level, static_cast<uint64_t>(i), settings, validator);
+    });
+    Report("generate_level", "", 0, levels / (ms / 1000.0), "levels/s");
+
+    const int batch = 2000;
+    std::vector<Level> generated;
+    ms = MeasureBestMs(3, [&] { GenerateLevels(generated, 0, batch, settings); });
+    Report("generate_levels", "threads", DefaultThreadCount(), batch / (ms / 1000.0), "levels/s");
+
+    // Solvability search alone, over the levels just generated
+    LevelAnalyzer analyzer;
+    LevelAnalysis analysis;
+    ms = MeasureBestMs(benchRepeats, [&] {
+        for (const Level& generatedLevel : generated) {
+            AnalyzeLevel(analyzer, generatedLevel.platforms, generatedLevel.playerSpawn, generatedLevel.flagPosition,
+                         settings.playerSize, analysis);
+        }
+    });
+    Report("analyze_level", "", 0, generated.size() / (ms / 1000.0), "levels/s");
+
+    // Switching to a level from a mapped level file (InitGame on a view into the mapping)
+    const char* levelPath = "bench_levels.ftlv";
+    LevelFile file;
+    if (SaveLevelFile(levelPath, generated) && OpenLevelFile(file, levelPath)) {
+        GameState switched;
+        LevelView view;
+        ms = MeasureBestMs(benchRepeats, [&] {
+            for (int i = 0; i < file.levelCount; i++) {
+                GetLevelView(file, i, view);
+                InitGame(switched, view, defaultPlayerSpriteSize, defaultBatFrameSize);
+            }
+        });
+        Report("level_switch", "", 0, ms * 1000.0 / file.levelCount, "us");
+        CloseLevelFile(file);
+    }
+    std::remove(levelPath);
+
+    const int games = 2000;
+    GameState state;
+    ms = MeasureBestMs(benchRepeats, [&] {
+        for (int i = 0; i < games; i++) InitGame(state, static_cast<unsigned int>(i), defaultPlayerSpriteSize, defaultBatFrameSize);
+    });
+    Report("init_game", "", 0, games / (ms / 1000.0), "levels/s");
+}
+
+// RespawnBat with the player in open space, in the middle of the top third
+// (where most cells are too close), and moving every call so each respawn
+// rebuilds the valid cells; then 64 bats respawned per tick around four players
+static void BenchRespawnBat() {
+    BatSwarm swarm;
+    InitBatSwarm(swarm, defaultBatFrameSize, batScale);
+    AddBat(swarm, {0, 0}, {batSpeed, 0});
+    Rng rng;
+    SeedRng(rng, 11);
+    SpawnSampler spawns;
+    InitSpawnSampler(spawns);
+    Rectangle screen = {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)};
+
+    const int calls = 100000;
+    const char* names[2] = {"respawn_bat_open", "respawn_bat_crowded"};
+    Vector2 playerPositions[2] = {{100, screenHeight - 100}, {screenWidth / 2, screenHeight / 6}};
+    for (int i = 0; i < 2; i++) {
+        double ms = MeasureBestMs(benchRepeats, [&] {
+            for (int c = 0; c < calls; c++) RespawnBat(swarm, 0, &playerPositions[i], 1, rng, screen, spawns);
+        });
+        Report(names[i], "", 0, calls / (ms / 1000.0), "calls/s");
+    }
+
+    const int movingCalls = 10000;
+    double movingMs = MeasureBestMs(benchRepeats, [&] {
+        for (int c = 0; c < movingCalls; c++) {
+            Vector2 player = {static_cast<float>(c % screenWidth), screenHeight / 6.0f};
+            RespawnBat(swarm, 0, &player, 1, rng, screen, spawns);
+        }
+    });
+    Report("respawn_bat_moving", "", 0, movingCalls / (movingMs / 1000.0), "calls/s");
+
+    const int batchSize = 64;
+    const int ticks = 1000;
+    for (int i = 1; i < batchSize; i++) AddBat(swarm, {0, 0}, {batSpeed, 0});
+    double batchMs = MeasureBestMs(benchRepeats, [&] {
+        for (int t = 0; t < ticks; t++) {
+            Vector2 players[4] = {{100.0f + t % 50, 500}, {400, 100}, {700, 300}, {1000.0f - t % 50, 150}};
+            for (int i = 0; i < batchSize; i++) RespawnBat(swarm, i, players, 4, rng, screen, spawns);
+        }
+    });
+    Report("respawn_bat_batch", "bats", batchSize, batchMs * 1000.0 / ticks, "us/tick");
+}
+
+// Recording 30 s of play into the rewind buffer, what it takes up, and stepping back through it
+static void BenchRewind() {
+    GameState initial;
+    InitGame(initial, 1234, defaultPlayerSpriteSize, defaultBatFrameSize);
+    const int ticks = 30 * ticksPerSecond;
+    std::vector<uint8_t> script = MakeInputScript(ticks, 99);
+    std::vector<GameState> states(ticks, initial);
+    GameState state = initial;
+    for (int t = 0; t < ticks; t++) {
+        RunScript(state, initial, {script[t]});
+        states[t] = state;
+    }
+
+    RewindBuffer rewind;
+    InitRewindBuffer(rewind, DefaultRewindSettings());
+    double recordMs = MeasureBestMs(benchRepeats, [&] {
+        ClearRewindBuffer(rewind);
+        for (const GameState& tick : states) RecordRewindFrame(rewind, tick);
+    });
+    Report("rewind_record", "", 0, recordMs * 1000.0 / ticks, "us/tick");
+    Report("rewind_memory_30s", "", 0, GetRewindBytesUsed(rewind) / 1024.0, "KB");
+
+    // Refilling is not part of the measurement, so time each pass by hand
+    double stepMs = 1e30;
+    for (int r = 0; r < benchRepeats; r++) {
+        ClearRewindBuffer(rewind);
+        for (const GameState& tick : states) RecordRewindFrame(rewind, tick);
+        auto start = std::chrono::steady_clock::now();
+        while (RewindGameState(rewind, state)) {
+        }
+        stepMs = std::min(stepMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    Report("rewind_step", "", 0, stepMs * 1000.0 / (ticks - 1), "us/tick");
+}
+
+static std::string JsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static bool WriteJson(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "{\"benchmarks\":[\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(file, "  {\"name\":\"%s\",\"parameter\":\"%s\",\"count\":%ld,\"value\":%.6g,\"unit\":\"%s\"}%s\n",
+                JsonEscape(r.name).c_str(), JsonEscape(r.parameter).c_str(), r.count, r.value,
+                JsonEscape(r.unit).c_str(), i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    return fclose(file) == 0;
+}
+
+static bool WriteCsv(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "name,parameter,count,value,unit\n");
+    for (const BenchResult& r : results) {
+        fprintf(file, "%s,%s,%ld,%.6g,%s\n", r.name.c_str(), r.parameter.c_str(), r.count, r.value, r.unit.c_str());
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    int batCount = 100000;
+    int maxPlatforms = 1000000;
+    std::string jsonPath, csvPath;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bats") == 0 && i + 1 < argc) batCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-platforms") == 0 && i + 1 < argc) maxPlatforms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvPath = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) benchRepeats = 3;
+    }
+
+    printf("bat swarm vector path: %s\n", GetBatSwarmVectorPath());
+    BenchStep();
+    for (int platforms = 100; platforms <= maxPlatforms; platforms *= 10) {
+        BenchStepCollision(platforms);
+    }
+    BenchBatSwarm(1000);
+    BenchBatSwarm(batCount);
+    BenchContactSweep(64);
+    BenchContactSweep(1024);
+    BenchLevelGeneration();
+    BenchRespawnBat();
+    BenchRewind();
+
+    if (!jsonPath.empty() && !WriteJson(jsonPath)) {
+        fprintf(stderr, "Failed to write %s\n", jsonPath.c_str());
+        return 1;
+    }
+    if (!csvPath.empty() && !WriteCsv(csvPath)) {
+        fprintf(stderr, "Failed to write %s\n", csvPath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -1,96 +1,25 @@
 #include "raylib.h"
+#include "game.h"
+#include "input_recording.h"
+#include "level_file.h"
+#include "netplay.h"
+#include "sim_thread.h"
+#include "profiler.h"
+#include "profiler_overlay.h"
+#include "rewind_buffer.h"
+#include "asset_manager.h"
+#include "audio_system.h"
+#include "bot.h"
+#include "hud.h"
+#include "tilemap_renderer.h"
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <memory>
 #include <string>
-#include <cmath> // For distance calculation
+#include <cmath> // For the flag wave
 #include <ctime> // For seeding random number generator
-
-// Game constants
-const int screenWidth = 1280;
-const int screenHeight = 720;
-const float playerSpeed = 5.0f;
-const float gravity = 0.4f;                // Reduced gravity for smoother falling
-const float jumpForce = -10.0f;            // Reduced initial jump force
-const float jumpHoldForce = -0.5f;         // Additional force when holding jump button
-const float maxJumpHoldTime = 15.0f;       // Maximum frames to apply additional jump force
-const float airControlFactor = 0.7f;       // Reduced control in air (0.0 to 1.0)
-const float terminalVelocity = 12.0f;      // Maximum falling speed
-const int coyoteTimeFrames = 6;            // Frames where player can still jump after leaving platform
-const int jumpBufferFrames = 6;            // Frames where jump input is remembered before landing
-const int tileSize = 64;  // Size of each tile in pixels
-const float batScale = 0.1875f; // Bat scale factor
-const float batSpeed = 2.0f; // Bat movement speed
-const int invulnerabilityFrames = 60; // 1 second at 60 FPS
-
-// Player structure
-struct Player {
-    Vector2 position;
-    Vector2 velocity;
-    float speed;
-    bool isJumping;
-    Rectangle bounds;
-    bool isFacingRight;  // To track player direction for sprite flipping
-    Texture2D texture;
-    int invulnerabilityTimer; // Timer for invulnerability after collision
-    int coyoteTimer;          // Timer for coyote time
-    int jumpBufferTimer;      // Timer for jump buffer
-    int jumpHoldTimer;        // Timer for variable jump height
-    bool isJumpHeld;          // Whether jump button is being held
-};
-
-// Platform/ground structure
-struct Platform {
-    Rectangle rect;
-    Texture2D texture;
-};
-
-// Flag structure
-struct Flag {
-    Vector2 position;
-    Rectangle bounds;
-    Texture2D texture;
-    bool reached;
-    float waveTimer;
-    Color color;
-};
-
-// Bat enemy structure
-struct Bat {
-    Vector2 position;
-    Vector2 velocity;
-    Rectangle bounds;
-    Texture2D texture;
-    float scale;
-    bool active;
-    int respawnTimer; // Timer to prevent immediate respawn
-    
-    // Animation properties
-    Texture2D frames[8]; // Array to hold animation frames
-    int currentFrame;    // Current animation frame
-    int frameCounter;    // Counter for animation timing
-    int framesSpeed;     // Speed of animation (frames per update)
-    
-    // Method to calculate the scaled width
-    float GetScaledWidth() const {
-        return texture.width * scale;
-    }
-    
-    // Method to calculate the scaled height
-    float GetScaledHeight() const {
-        return texture.height * scale;
-    }
-};
-
-// Score structure
-struct Score {
-    int bat;    // Points for the bat
-    int player; // Points for the player
-};
-
-// Function to calculate distance between two points
-float CalculateDistance(Vector2 p1, Vector2 p2) {
-    return sqrtf(powf(p2.x - p1.x, 2) + powf(p2.y - p1.y, 2)); // Using sqrtf and powf for float precision
-}
+#include <cstring>
 
 // Function to blend two colors with a bias towards the base color
 Color BlendColors(Color base, Color tint, float factor = 0.3f) {
@@ -102,541 +31,316 @@ Color BlendColors(Color base, Color tint, float factor = 0.3f) {
     return result;
 }
 
-// Function to respawn bat at a random position away from player
-void RespawnBat(Bat& bat, const Player& player) {
-    // Calculate minimum distance (5 bat lengths)
-    float minDistance = bat.GetScaledWidth() * 5;
-    
-    // Keep generating positions until we find one that's far enough
-    Vector2 newPos;
-    float distance;
-    int attempts = 0;
-    const int maxAttempts = 100; // Prevent infinite loop
-    
-    do {
-        // Generate random position in the sky
-        newPos.x = static_cast<float>(GetRandomValue(0, static_cast<int>(screenWidth - bat.GetScaledWidth())));
-        newPos.y = static_cast<float>(GetRandomValue(0, screenHeight / 3)); // Top third of the screen
-        
-        // Calculate distance to player
-        distance = CalculateDistance(newPos, player.position);
-        
-        attempts++;
-        if (attempts >= maxAttempts) {
-            // If we can't find a good position after many attempts, 
-            // place the bat at the opposite side of the screen from the player
-            newPos.x = (player.position.x < screenWidth / 2) ? 
-                       (screenWidth - bat.GetScaledWidth() - 10) : 10;
-            newPos.y = 50;
-            break;
-        }
-    } while (distance < minDistance);
-    
-    // Set the new position
-    bat.position = newPos;
-    
-    // Reset velocity (optional: give it a random direction)
-    // Make sure the bat has a non-zero velocity
-    bat.velocity.x = (GetRandomValue(0, 1) == 0 ? -1.0f : 1.0f) * batSpeed;
-    bat.velocity.y = static_cast<float>(GetRandomValue(0, 1)) * batSpeed;
-    
-    // If both velocities are zero, give it a default movement
-    if (bat.velocity.x == 0 && bat.velocity.y == 0) {
-        bat.velocity.x = batSpeed;
-    }
-    
-    // Update bounds
-    bat.bounds.x = bat.position.x;
-    bat.bounds.y = bat.position.y;
-    bat.bounds.width = bat.GetScaledWidth();
-    bat.bounds.height = bat.GetScaledHeight();
-    
-    // Activate the bat
-    bat.active = true;
+// Sample the keys the simulation cares about for this tick
+InputFrame ReadKeyboardInput() {
+    InputFrame input = {0};
+    if (IsKeyDown(KEY_LEFT)) input.buttons |= INPUT_LEFT;
+    if (IsKeyDown(KEY_RIGHT)) input.buttons |= INPUT_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input.buttons |= INPUT_SPACE;
+    if (IsKeyDown(KEY_UP)) input.buttons |= INPUT_UP;
+    return input;
 }
 
-// Function to load a texture or create a fallback if file doesn't exist
-Texture2D LoadTextureOrDefault(const std::string& filename, int width, int height, Color color) {
-    // Print debug info
-    std::cout << "Attempting to load texture: " << filename << std::endl;
+int main(int argc, char** argv) {
+    // --record <file> saves this run's input; --replay <file> plays one back
+    // --uncapped renders as fast as possible instead of at the monitor's refresh rate
+    // --bot lets the bot play instead of the keyboard
+    // --levels <file.ftlv> [--level N] plays baked levels (from level N on) instead of generating them
+    // --versus 1|2 --peer host:port [--port P] [--seed S] races another player over UDP
+    //   (both sides pass the same seed); --net-latency ms, --net-jitter ms and --net-loss fraction
+    //   add fake network trouble to outgoing packets for testing
+    std::string recordPath, replayPath, levelsPath, peerAddress;
+    int levelIndex = 0;
+    bool uncapped = false;
+    bool useBot = false;
+    int versusPlayer = 0;
+    int versusPort = 0;
+    uint64_t versusSeed = 1;
+    NetConditions netConditions = {0, 0, 0.0f};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelsPath = argv[++i];
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) levelIndex = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--uncapped") == 0) uncapped = true;
+        else if (strcmp(argv[i], "--bot") == 0) useBot = true;
+        else if (strcmp(argv[i], "--versus") == 0 && i + 1 < argc) versusPlayer = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--peer") == 0 && i + 1 < argc) peerAddress = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) versusPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) versusSeed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--net-latency") == 0 && i + 1 < argc) netConditions.latencyMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--net-jitter") == 0 && i + 1 < argc) netConditions.jitterMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--net-loss") == 0 && i + 1 < argc) netConditions.loss = static_cast<float>(atof(argv[++i]));
+    }
     
-    // Check if file exists
-    if (FileExists(filename.c_str())) {
-        std::cout << "File exists! Loading texture from file." << std::endl;
-        Texture2D texture = LoadTexture(filename.c_str());
-        std::cout << "Texture loaded. Width: " << texture.width << ", Height: " << texture.height << std::endl;
-        return texture;
-    } else {
-        std::cout << "File not found. Creating fallback texture." << std::endl;
-        // Create a placeholder texture if the file doesn't exist
-        Image img = GenImageColor(width, height, color);
-        Texture2D texture = LoadTextureFromImage(img);
-        UnloadImage(img);
-        return texture;
+    // A versus match has its own level and no replay or recording
+    UdpAddress peer = {};
+    bool versus = (versusPlayer == 1 || versusPlayer == 2) && ParseUdpAddress(peerAddress, peer);
+    if (versusPlayer != 0 && !versus) {
+        std::cout << "--versus needs 1 or 2 and --peer host:port; playing alone" << std::endl;
     }
-}
+    if (versus) {
+        if (versusPort == 0) versusPort = 47800 + versusPlayer - 1;
+        replayPath.clear();
+        levelsPath.clear();
+        recordPath.clear();
+    }
+    InputRecording replay = {};
+    bool replaying = !replayPath.empty() && LoadInputRecording(replay, replayPath);
 
-// Function to generate random stair positions and return the top stair position
-Vector2 GenerateRandomStairs(std::vector<Platform>& platforms, Texture2D groundTexture) {
-    // Random parameters for stairs
-    int stairCount = GetRandomValue(4, 8); // Random number of stairs between 4 and 8
-    int startX = GetRandomValue(screenWidth / 2, screenWidth - 300); // Random starting X position
-    int startY = GetRandomValue(screenHeight - 300, screenHeight - 100); // Random starting Y position
-    int stairWidth = GetRandomValue(1, 3) * tileSize; // Random stair width (1-3 tiles)
-    
-    // Create the staircase
-    Vector2 topStairPos = {0, 0}; // Will store the position of the top stair
-    
-    for (int i = 0; i < stairCount; i++) {
-        Platform stair = {
-            {startX + (i * tileSize / 2), startY - (i * tileSize), stairWidth, tileSize},
-            groundTexture
-        };
-        platforms.push_back(stair);
-        
-        // Save the position of the top stair
-        if (i == stairCount - 1) {
-            topStairPos.x = stair.rect.x + stair.rect.width - 40; // Position flag near the right edge of top stair
-            topStairPos.y = stair.rect.y - 60; // Position flag above the top stair
-        }
+    // Recordings only know the seed, so they cannot reproduce a level from a file
+    LevelFile levelFile = {};
+    LevelView fileLevel = {};
+    bool useLevelFile = !levelsPath.empty() && !replaying && OpenLevelFile(levelFile, levelsPath) &&
+                        GetLevelView(levelFile, levelIndex, fileLevel);
+    if (useLevelFile && !recordPath.empty()) {
+        std::cout << "Recording is not supported with --levels; not recording" << std::endl;
+        recordPath.clear();
     }
     
-    return topStairPos;
-}
-
-int main() {
     // Initialize audio device first
     InitAudioDevice();
     
-    // Seed random number generator
-    SetRandomSeed((unsigned int)time(NULL));
+    // Seed random number generator (a replay must reuse the recorded seed)
+    unsigned int seed = replaying ? replay.seed : (unsigned int)time(NULL);
+    SetRandomSeed(seed);
     
     // Initialize window
+    // Rendering runs at display rate; the simulation has its own fixed tick below
     InitWindow(screenWidth, screenHeight, "Side Scroller Game");
-    SetTargetFPS(60);
+    SetTargetFPS(uncapped ? 0 : GetMonitorRefreshRate(GetCurrentMonitor()));
     
     // Get the current working directory and print it
     const char* currentDir = GetWorkingDirectory();
     std::cout << "Current working directory: " << currentDir << std::endl;
     
-    // Define the asset paths - use absolute paths to be sure
+    // Define the asset paths - use absolute paths to be sure,
+    // falling back to the parent directory when running from a build folder
     std::string assetPath = std::string(currentDir) + "/assets/";
-    // Try different paths to find the assets
-    std::string playerImagePath = assetPath + "player1.png"; // Changed to player1.png
-    std::string groundImagePath = assetPath + "ground.png";
-    std::string backgroundImagePath = assetPath + "background.png";
-    std::string batBasePath = assetPath + "02-Fly/__Bat02_Fly_00";
-    std::string flagImagePath = assetPath + "flag.png";
-    std::string musicPath = assetPath + "game-music-loop.mp3";
-    
-    // Also try looking in the parent directory
-    if (!FileExists(playerImagePath.c_str())) {
-        playerImagePath = "../assets/player1.png";
+    if (!DirectoryExists(assetPath.c_str())) {
+        assetPath = "../assets/";
     }
-    if (!FileExists(groundImagePath.c_str())) {
-        groundImagePath = "../assets/ground.png";
-    }
-    if (!FileExists(backgroundImagePath.c_str())) {
-        backgroundImagePath = "../assets/background.png";
-    }
-    if (!FileExists(flagImagePath.c_str())) {
-        flagImagePath = "../assets/flag.png";
-    }
-    if (!FileExists(musicPath.c_str())) {
-        musicPath = "../assets/game-music-loop.mp3";
-    }
-    
-    // Check if bat animation frames exist in parent directory
-    bool batFramesInParent = false;
-    std::string testBatFrame = assetPath + "02-Fly/__Bat02_Fly_000.png";
-    if (!FileExists(testBatFrame.c_str())) {
-        batBasePath = "../assets/02-Fly/__Bat02_Fly_00";
-        testBatFrame = "../assets/02-Fly/__Bat02_Fly_000.png";
-        if (FileExists(testBatFrame.c_str())) {
-            batFramesInParent = true;
-        }
+    std::cout << "Asset directory: " << assetPath << std::endl;
+    
+    // Player, the three tile kinds, flag and the eight bat frames are packed into one texture atlas;
+    // everything is decoded once and cached pre-decoded in assets.pak
+    AssetPaths assetPaths;
+    assetPaths.sprites = {
+        {"player", assetPath + "player1.png", 0.375f, 40, 40, BLUE},      // Drawn at batScale, so keep 2x that
+        {"ground", assetPath + "ground.png", 1.0f, tileSize, tileSize, DARKGRAY},
+        {"ledge", assetPath + "ledge.png", 1.0f, tileSize, tileSize, BROWN},      // Floating platforms
+        {"stair", assetPath + "stair.png", 1.0f, tileSize, tileSize, GRAY},       // The staircase to the flag
+        {"flag", assetPath + "flag.png", 1.0f, 40, 60, YELLOW}
+    };
+    for (int i = 0; i < batAnimationFrames; i++) {
+        assetPaths.sprites.push_back({"bat" + std::to_string(i), assetPath + "02-Fly/__Bat02_Fly_00" + std::to_string(i) + ".png",
+                                      0.375f, 60, 40, RED});
     }
-    
-    std::cout << "Player image path: " << playerImagePath << std::endl;
-    std::cout << "Bat frames base path: " << batBasePath << std::endl;
-    
-    // Load textures with fallbacks if files don't exist
-    Texture2D playerTexture = LoadTextureOrDefault(playerImagePath, 40, 40, BLUE);
-    Texture2D groundTexture = LoadTextureOrDefault(groundImagePath, tileSize, tileSize, DARKGRAY);
-    Texture2D flagTexture = LoadTextureOrDefault(flagImagePath, 40, 60, YELLOW);
-    
-    // Load bat animation frames
-    Texture2D batFrames[8];
+    assetPaths.background = assetPath + "background.png";
+    assetPaths.music = assetPath + "game-music-loop-6-144641.mp3";
+    assetPaths.bonusSound = assetPath + "game-bonus.mp3";
+    assetPaths.pak = assetPath + "assets.pak";
+    
+    GameAssets assets = {};
+    LoadGameAssets(assets, assetPaths);
+    const TextureAtlas& atlas = assets.atlas;
+    
+    // Music and sound effects play on their own thread from here on
+    AudioSystem audio;
+    StartAudio(audio, DefaultAudioSettings(), assets.music.data, assets.music.size, assets.bonus.data, assets.bonus.size);
+    
+    const AtlasFrame playerFrame = *FindAtlasFrame(atlas, "player");
+    const AtlasFrame groundFrame = *FindAtlasFrame(atlas, "ground");
+    const AtlasFrame flagFrame = *FindAtlasFrame(atlas, "flag");
+    Rectangle batFrames[batAnimationFrames];
     bool usingBatFallback = true;
-    
-    // Try to load all bat animation frames
-    for (int i = 0; i < 8; i++) {
-        std::string frameFilename = batBasePath + std::to_string(i) + ".png";
-        std::cout << "Attempting to load bat frame: " << frameFilename << std::endl;
-        
-        if (FileExists(frameFilename.c_str())) {
-            batFrames[i] = LoadTexture(frameFilename.c_str());
-            usingBatFallback = false;
-            std::cout << "Loaded bat frame " << i << " successfully" << std::endl;
+    for (int i = 0; i < batAnimationFrames; i++) {
+        const AtlasFrame* frame = FindAtlasFrame(atlas, "bat" + std::to_string(i));
+        batFrames[i] = frame->source;
+        if (frame->fromFile) usingBatFallback = false;
+    }
+    Vector2 batFrameSize = FindAtlasFrame(atlas, "bat0")->sourceSize;
+    
+    // Build the first level and place player, bat and flag; each flag reached
+    // moves on to the next level. Sprite sizes feed the collision bounds, so a
+    // replay uses the recorded ones even if the art changed.
+    Vector2 playerSpriteSize = replaying ? replay.playerSpriteSize : playerFrame.sourceSize;
+    if (replaying) batFrameSize = replay.batFrameSize;
+    GameState state;
+    LevelSequence sequence = {};
+    std::unique_ptr<RollbackSession> versusSession;
+    NetPeer netPeer;
+    if (versus) {
+        // Both sides build the same race from the shared seed and fixed sprite sizes
+        versusSession.reset(new RollbackSession());
+        BeginRollbackSession(*versusSession, versusPlayer - 1, versusSeed);
+        if (!OpenNetPeer(netPeer, static_cast<uint16_t>(versusPort), peer, netConditions, versusSeed)) {
+            std::cout << "Cannot open UDP port " << versusPort << "; playing alone" << std::endl;
+            versusSession.reset();
+            versus = false;
         } else {
-            // Create a fallback texture for this frame
-            Image img = GenImageColor(60, 40, RED);
-            batFrames[i] = LoadTextureFromImage(img);
-            UnloadImage(img);
-            std::cout << "Using fallback for bat frame " << i << std::endl;
+            std::cout << "Versus as player " << versusPlayer << " on port " << versusPort << ", peer "
+                      << peerAddress << ", seed " << versusSeed << std::endl;
         }
     }
-    
-    // Use the first frame as the main texture
-    Texture2D batTexture = batFrames[0];
-    
-    // For background, try to load from file or create a gradient
-    Texture2D backgroundTexture;
-    if (FileExists(backgroundImagePath.c_str())) {
-        backgroundTexture = LoadTexture(backgroundImagePath.c_str());
+    if (versus) {
+        // The local game is inside the session
+    } else if (useLevelFile) {
+        BeginLevelSequence(sequence, state, levelFile, levelIndex, playerSpriteSize, batFrameSize);
     } else {
-        // Create a gradient background manually
-        Image backgroundImg = GenImageColor(screenWidth, screenHeight, SKYBLUE);
-        // Draw a gradient effect manually
-        for (int y = 0; y < screenHeight; y++) {
-            float factor = static_cast<float>(y) / screenHeight;
-            Color color = {
-                static_cast<unsigned char>(SKYBLUE.r + (WHITE.r - SKYBLUE.r) * factor),
-                static_cast<unsigned char>(SKYBLUE.g + (WHITE.g - SKYBLUE.g) * factor),
-                static_cast<unsigned char>(SKYBLUE.b + (WHITE.b - SKYBLUE.b) * factor),
-                255
-            };
-            for (int x = 0; x < screenWidth; x++) {
-                ImageDrawPixel(&backgroundImg, x, y, color);
-            }
-        }
-        backgroundTexture = LoadTextureFromImage(backgroundImg);
-        UnloadImage(backgroundImg);
+        BeginLevelSequence(sequence, state, seed, playerSpriteSize, batFrameSize);
     }
     
-    // Initialize player
-    Player player = {
-        {100, screenHeight - tileSize - playerTexture.height * batScale},  // position adjusted to be on top of the floor
-        {0, 0},                     // velocity
-        playerSpeed,                // speed
-        false,                      // isJumping
-        {100, screenHeight - tileSize - playerTexture.height * batScale, playerTexture.width * batScale, playerTexture.height * batScale},  // bounds updated to match bat scale
-        true,                       // isFacingRight
-        playerTexture,              // texture
-        0,                          // invulnerabilityTimer
-        0,                          // coyoteTimer
-        0,                          // jumpBufferTimer
-        0,                          // jumpHoldTimer
-        false                       // isJumpHeld
-    };
-    
-    // Initialize bat enemy
-    Bat bat = {
-        {static_cast<float>(screenWidth / 2), 100.0f},     // position
-        {batSpeed, batSpeed * 0.5f},              // velocity - ensure it has vertical movement
-        {0, 0, 0, 0},               // bounds (will be updated)
-        batTexture,                 // texture (first frame)
-        batScale,                   // scale
-        true,                       // active
-        0,                          // respawnTimer
-        {batFrames[0], batFrames[1], batFrames[2], batFrames[3], 
-         batFrames[4], batFrames[5], batFrames[6], batFrames[7]}, // animation frames
-        0,                          // currentFrame
-        0,                          // frameCounter
-        5                           // framesSpeed (adjust for desired animation speed)
-    };
-    
-    // Initialize score
-    Score score = {0, 0};
-    
-    // Create ground/platforms
-    std::vector<Platform> platforms;
-    int numTiles = screenWidth / tileSize + 1;
-    
-    // Add ground tiles
-    for(int i = 0; i < numTiles; i++) {
-        Platform platform = {
-            {i * tileSize, screenHeight - tileSize, tileSize, tileSize},
-            groundTexture
-        };
-        platforms.push_back(platform);
-    }
-    
-    // Add some platforms for jumping onto
-    platforms.push_back({{300, screenHeight - 200, tileSize * 3, tileSize}, groundTexture});
-    platforms.push_back({{600, screenHeight - 300, tileSize * 2, tileSize}, groundTexture});
-    platforms.push_back({{900, screenHeight - 250, tileSize * 4, tileSize}, groundTexture});
-    
-    // Reserve space for stairs
-    platforms.reserve(platforms.size() + 8); // Reserve space for up to 8 stairs
-    
-    // Generate random stairs and get the position for the flag
-    Vector2 flagPosition = GenerateRandomStairs(platforms, groundTexture);
-    
-    // Initialize flag at the top of the stairs
-    Flag flag = {
-        flagPosition,
-        {flagPosition.x, flagPosition.y, 40, 60},
-        flagTexture,
-        false, // not reached yet
-        0.0f,  // wave timer
-        YELLOW // color
-    };
-    
-    // Update bat bounds based on scaled dimensions
-    bat.bounds.width = bat.GetScaledWidth();
-    bat.bounds.height = bat.GetScaledHeight();
-    bat.bounds.x = bat.position.x;
-    bat.bounds.y = bat.position.y;
-    
-    // Load music
-    Music gameMusic = { 0 };
-    bool musicLoaded = false;
-    
-    if (FileExists(musicPath.c_str())) {
-        std::cout << "Loading music from: " << musicPath << std::endl;
-        gameMusic = LoadMusicStream(musicPath.c_str());
-        musicLoaded = true;
-        
-        // Set music volume and play it
-        SetMusicVolume(gameMusic, 0.5f);  // 50% volume
-        PlayMusicStream(gameMusic);
+    InputRecording recording;
+    BeginInputRecording(recording, seed, playerSpriteSize, batFrameSize);
+    
+    // Each tick's buttons come from the keyboard or the bot (a replay overrides both while it lasts)
+    SharedButtons keyboard = {};
+    Bot bot;
+    InitBot(bot, DefaultBotSettings());
+    InputProvider playerInput = useBot ? MakeBotInputProvider(bot)
+                                       : InputProvider([&keyboard](const GameState&) { return TakeButtons(keyboard); });
+    
+    // Fixed 60 Hz simulation on its own thread; render frames draw the latest
+    // snapshot, between its tick and the one before
+    // The last 45 seconds of ticks, for holding R to step back (not in a versus race)
+    RewindBuffer rewind;
+    InitRewindBuffer(rewind, DefaultRewindSettings());
+    SimThread sim;
+    Score heardScore; // Score changes since the last frame trigger sound effects
+    if (versus) {
+        heardScore = versusSession->state.games[versusSession->localPlayer].score;
+        StartVersusSimThread(sim, *versusSession, netPeer, playerInput);
     } else {
-        std::cout << "Music file not found at: " << musicPath << std::endl;
+        heardScore = state.score;
+        StartSimThread(sim, state, sequence, playerInput, replaying ? &replay : nullptr,
+                       recordPath.empty() ? nullptr : &recording, &rewind);
     }
+    int drawnLevel = -1;
     
-    // Game state
-    bool gameOver = false;
+    // Bake all ground/platform/stair tiles into static meshes (rebuilt only when the level changes)
+    // (one set of meshes per resident world chunk, built as chunks stream in)
+    TilemapRenderer tilemap = {};
+    InitTilemap(tilemap, atlas.texture, groundFrame.source);
+    SetTilemapTileSource(tilemap, TILE_LEDGE, FindAtlasFrame(atlas, "ledge")->source);
+    SetTilemapTileSource(tilemap, TILE_STAIR, FindAtlasFrame(atlas, "stair")->source);
+    
+    Hud hud;
+    const char* controlsText = useBot ? "Bot playing (--bot) | Hold R: Rewind"
+                                      : "Arrow Keys: Move | Space/Up: Jump | Hold R: Rewind";
+    InitHud(hud, controlsText, playerFrame.sourceSize);
     
     // Game loop
+    bool showProfiler = false;
     while (!WindowShouldClose()) {
-        // Update music if loaded
-        if (musicLoaded) {
-            UpdateMusicStream(gameMusic);
+        BeginProfilerFrame();
+        
+        // Hand this frame's keys to the simulation thread
+        int64_t zoneStart = BeginProfileZone();
+        PublishButtons(keyboard, ReadKeyboardInput().buttons);
+        sim.rewinding.store(IsKeyDown(KEY_R), std::memory_order_relaxed);
+        
+        // F3 toggles the profiler overlay (profiling runs only while it is shown), F4 saves a trace
+        if (IsKeyPressed(KEY_F3)) {
+            showProfiler = !showProfiler;
+            SetProfilerEnabled(showProfiler);
+        }
+        if (IsKeyPressed(KEY_F4)) {
+            bool saved = WriteChromeTrace("profile_trace.json");
+            std::cout << (saved ? "Saved profile_trace.json" : "Failed to write profile_trace.json") << std::endl;
         }
+        EndProfileZone(PROFILE_INPUT, zoneStart);
         
-        // Update
-        if (!gameOver) {
-            // Handle player movement
-            float moveSpeed = player.speed;
-            if (player.isJumping) {
-                // Reduce control in the air
-                moveSpeed *= airControlFactor;
-            }
-            
-            if (IsKeyDown(KEY_RIGHT)) {
-                player.position.x += moveSpeed;
-                player.isFacingRight = true;
-            }
-            if (IsKeyDown(KEY_LEFT)) {
-                player.position.x -= moveSpeed;
-                player.isFacingRight = false;
-            }
-            
-            // Handle jump buffer (remember jump input for a few frames)
-            if (IsKeyPressed(KEY_SPACE) || IsKeyPressed(KEY_UP)) {
-                player.jumpBufferTimer = jumpBufferFrames;
-            }
-            
-            // Track if jump button is held down
-            player.isJumpHeld = IsKeyDown(KEY_SPACE) || IsKeyDown(KEY_UP);
-            
-            // Handle jumping with coyote time and jump buffer
-            if ((player.jumpBufferTimer > 0) && (player.coyoteTimer > 0 || !player.isJumping)) {
-                player.velocity.y = jumpForce;
-                player.isJumping = true;
-                player.jumpHoldTimer = maxJumpHoldTime;
-                player.jumpBufferTimer = 0;
-                player.coyoteTimer = 0;
-            }
-            
-            // Variable jump height based on how long jump is held
-            if (player.isJumpHeld && player.jumpHoldTimer > 0 && player.velocity.y < 0) {
-                player.velocity.y += jumpHoldForce;
-                player.jumpHoldTimer--;
-            } else {
-                player.jumpHoldTimer = 0;
-            }
-
-            // Apply gravity with terminal velocity
-            player.velocity.y += gravity;
-            if (player.velocity.y > terminalVelocity) {
-                player.velocity.y = terminalVelocity;
-            }
-            
-            // Update position based on velocity
-            player.position.y += player.velocity.y;
-            
-            // Decrement timers
-            if (player.jumpBufferTimer > 0) player.jumpBufferTimer--;
-            if (player.coyoteTimer > 0) player.coyoteTimer--;
-            
-            // Check if player has fallen off the sides of the screen
-            if (player.position.x < -player.bounds.width * 2 || 
-                player.position.x > screenWidth + player.bounds.width * 2 || 
-                player.position.y > screenHeight + player.bounds.height * 2) {
-                // Respawn player in the middle of the screen
-                player.position.x = screenWidth / 2 - player.bounds.width / 2;
-                player.position.y = screenHeight / 2 - player.bounds.height / 2;
-                player.velocity.x = 0;
-                player.velocity.y = 0;
-            }
-            
-            // Ground collision - check against all platforms
-            bool onGround = false;
-            for(const auto& platform : platforms) {
-                // Check if player is colliding with platform
-                if (player.position.y + player.bounds.height > platform.rect.y &&
-                    player.position.y < platform.rect.y + platform.rect.height &&
-                    player.position.x + player.bounds.width > platform.rect.x &&
-                    player.position.x < platform.rect.x + platform.rect.width) {
-                    
-                    // Check if landing on top of platform (only if falling)
-                    if (player.velocity.y > 0 && 
-                        player.position.y + player.bounds.height - player.velocity.y <= platform.rect.y + 5) {
-                        player.position.y = platform.rect.y - player.bounds.height;
-                        player.velocity.y = 0;
-                        onGround = true;
-                    }
-                    // Check if hitting platform from below
-                    else if (player.velocity.y < 0 && 
-                             player.position.y - player.velocity.y >= platform.rect.y + platform.rect.height - 5) {
-                        player.position.y = platform.rect.y + platform.rect.height;
-                        player.velocity.y = 0;
-                        player.jumpHoldTimer = 0; // Stop variable jump when hitting ceiling
-                    }
-                    // Check if hitting platform from the sides
-                    else if (player.position.x + player.bounds.width > platform.rect.x && 
-                             player.position.x < platform.rect.x + platform.rect.width) {
-                        // Left side collision
-                        if (player.velocity.x > 0 && 
-                            player.position.x + player.bounds.width - player.velocity.x <= platform.rect.x + 5) {
-                            player.position.x = platform.rect.x - player.bounds.width;
-                        }
-                        // Right side collision
-                        else if (player.velocity.x < 0 && 
-                                 player.position.x - player.velocity.x >= platform.rect.x + platform.rect.width - 5) {
-                            player.position.x = platform.rect.x + platform.rect.width;
-                        }
-                    }
-                }
-            }
-            
-            // Update jumping state and coyote time
-            if (onGround) {
-                player.isJumping = false;
-                player.coyoteTimer = coyoteTimeFrames;
-            } else if (!player.isJumping) {
-                // Start coyote time when player leaves a platform without jumping
-                player.isJumping = true;
-                if (player.coyoteTimer <= 0) {
-                    player.coyoteTimer = coyoteTimeFrames;
-                }
-            }
-
-            // Update player bounds
-            player.bounds.x = player.position.x;
-            player.bounds.y = player.position.y;
-            
-            // Update invulnerability timer
-            if (player.invulnerabilityTimer > 0) {
-                player.invulnerabilityTimer--;
-            }
-            
-            // Update bat movement
-            if (bat.active) {
-                // Update respawn timer
-                if (bat.respawnTimer > 0) {
-                    bat.respawnTimer--;
-                }
-                
-                // Update animation
-                bat.frameCounter++;
-                if (bat.frameCounter >= bat.framesSpeed) {
-                    bat.frameCounter = 0;
-                    bat.currentFrame++;
-                    
-                    if (bat.currentFrame > 7) bat.currentFrame = 0;
-                    
-                    // Update the current texture to the current frame
-                    bat.texture = bat.frames[bat.currentFrame];
-                }
-                
-                // Move bat
-                bat.position.x += bat.velocity.x;
-                bat.position.y += bat.velocity.y;
-                
-                // Bounce off screen edges
-                if (bat.position.x <= 0 || bat.position.x + bat.GetScaledWidth() >= screenWidth) {
-                    bat.velocity.x *= -1;
-                }
-                if (bat.position.y <= 0 || bat.position.y + bat.GetScaledHeight() >= screenHeight) {
-                    bat.velocity.y *= -1;
-                }
-                
-                // Update bat bounds
-                bat.bounds.x = bat.position.x;
-                bat.bounds.y = bat.position.y;
-                
-                // Check collision with player only if player is not invulnerable and bat can respawn
-                if (player.invulnerabilityTimer <= 0 && bat.respawnTimer <= 0 && 
-                    CheckCollisionRecs(player.bounds, bat.bounds)) {
-                    // Increment bat score
-                    score.bat++;
-                    
-                    // Make player invulnerable for a short time
-                    player.invulnerabilityTimer = invulnerabilityFrames;
-                    
-                    // Respawn bat in a random position away from player
-                    RespawnBat(bat, player);
-                    
-                    // Set bat respawn timer to prevent immediate respawn
-                    bat.respawnTimer = 30; // Half a second at 60 FPS
-                }
-            }
-
-            // Update flag wave animation
-            flag.waveTimer += 0.05f;
+        // Take the newest tick, if the simulation thread published one since the last frame
+        if (ConsumeTripleBuffer(sim.snapshots)) {
+            const GameSnapshot& latest = GetTripleBufferFront(sim.snapshots);
+            if (IsProfilerEnabled()) RecordProfileZone(PROFILE_SIMULATION, latest.stepStart, latest.stepEnd);
         }
+        const GameSnapshot& snapshot = GetTripleBufferFront(sim.snapshots);
+        float alpha = GetSnapshotInterpolationAlpha(snapshot);
+        
+        const InterpolationFrame& previousPositions = snapshot.previous;
+        const Player& player = snapshot.player;
+        const BatSwarm& bats = snapshot.bats;
+        const Flag& flag = snapshot.flag;
+        const Score& score = snapshot.score;
+        
+        // A bat hit or the flag since the last frame queues its sound on the audio thread
+        zoneStart = BeginProfileZone();
+        if (score.bat > heardScore.bat) TriggerSoundEffect(audio, SFX_BAT_HIT);
+        if (score.player > heardScore.player) TriggerSoundEffect(audio, SFX_FLAG);
+        heardScore = score;
+        EndProfileZone(PROFILE_AUDIO, zoneStart);
+        Vector2 playerPosition = InterpolatePosition(previousPositions.player, player.position, alpha);
+        float cameraX = InterpolatePosition({previousPositions.cameraX, 0}, {snapshot.cameraX, 0}, alpha).x;
+        Camera2D camera = {{0, 0}, {cameraX, 0}, 0.0f, 1.0f};
+        if (snapshot.levelIndex != drawnLevel) {
+            // New level: the old chunk meshes are stale
+            ClearTilemapPlatforms(tilemap);
+            drawnLevel = snapshot.levelIndex;
+        }
+        SyncTilemapWithChunks(tilemap, snapshot.chunks, snapshot.worldRevision);
 
-        // Check if player reached the flag
-        if (!flag.reached && CheckCollisionRecs(player.bounds, flag.bounds)) {
-            flag.reached = true;
-            score.player++; // Increment player score when flag is reached
-            
-            // Make the flag wave faster when reached
-            flag.waveTimer = 0.0f;
-            flag.color = GREEN; // Change flag color to green when reached
-            
-            // Set game over state
-            gameOver = true;
+        // Re-rasterize only the HUD lines whose values changed
+        zoneStart = BeginProfileZone();
+        if (snapshot.versus) {
+            int local = versusPlayer - 1;
+            SetHudControls(hud, snapshot.waitingForPeer          ? "Versus: waiting for the other player..."
+                                : snapshot.versusWinner < 0      ? "Versus: first to the flag wins"
+                                : snapshot.versusWinner == 2     ? "Versus: DRAW"
+                                : snapshot.versusWinner == local ? "Versus: YOU WIN"
+                                                                 : "Versus: you lose");
+        } else {
+            // While rewinding the controls line counts down the seconds left to rewind
+            HudText controls;
+            ClearHudText(controls);
+            if (snapshot.rewinding) {
+                AppendHudText(controls, "<< REWINDING (");
+                AppendHudInt(controls, snapshot.rewindSeconds);
+                AppendHudText(controls, " s left)");
+            } else {
+                AppendHudText(controls, controlsText);
+            }
+            SetHudControls(hud, controls.chars);
         }
+        // A versus race ends at the flag, with no next level to announce
+        UpdateHud(hud, player, score, snapshot.levelIndex, snapshot.levelComplete && !snapshot.versus);
+        EndProfileZone(PROFILE_DRAW_HUD, zoneStart);
 
         // Draw
         BeginDrawing();
+        zoneStart = BeginProfileZone();
         
-        // Draw background
-        DrawTexture(backgroundTexture, 0, 0, WHITE);
+        // Draw background, tiled and scrolling at a quarter of the camera speed
+        float backgroundWidth = static_cast<float>(std::max(assets.background.width, 1));
+        for (float x = -fmodf(cameraX * 0.25f, backgroundWidth); x < screenWidth; x += backgroundWidth) {
+            DrawTexture(assets.background, static_cast<int>(x), 0, WHITE);
+        }
+        
+        // World-space drawing follows the camera
+        BeginMode2D(camera);
         
         // Draw platforms
-        for(const auto& platform : platforms) {
-            DrawTexture(platform.texture, platform.rect.x, platform.rect.y, WHITE);
-        }
+        DrawTilemap(tilemap, {cameraX, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)});
         
-        // Draw flag with waving animation
-        if (FileExists(flagImagePath.c_str())) {
+        // Draw flag with waving animation (green once reached)
+        Color flagColor = flag.reached ? GREEN : YELLOW;
+        if (flagFrame.fromFile) {
             // If we have a flag texture, draw it
-            DrawTexture(flag.texture, flag.position.x, flag.position.y, flag.color);
+            DrawTextureRec(atlas.texture, flagFrame.source, flag.position, flagColor);
         } else {
             // Draw a simple animated flag
             for (int i = 0; i < 5; i++) {
                 float waveOffset = sinf(flag.waveTimer + i * 0.3f) * 5.0f;
-                DrawRectangle(flag.position.x, flag.position.y + i * 10 + waveOffset, 30, 8, flag.color);
+                DrawRectangle(flag.position.x, flag.position.y + i * 10 + waveOffset, 30, 8, flagColor);
             }
             // Draw flag pole
             DrawRectangle(flag.position.x - 5, flag.position.y, 5, 60, DARKGRAY);
         }
         
+        EndProfileZone(PROFILE_DRAW_WORLD, zoneStart);
+        zoneStart = BeginProfileZone();
+        
         // Draw player - flip texture based on direction and flash if invulnerable
         if (player.invulnerabilityTimer > 0 && (player.invulnerabilityTimer / 5) % 2 == 0) {
             // Skip drawing player every few frames to create flashing effect
@@ -655,101 +359,89 @@ int main() {
                 }
             }
             
-            // Draw player with appropriate direction
-            if (player.isFacingRight) {
-                DrawTextureEx(player.texture, player.position, 0.0f, baseScale, playerColor);
-            } else {
-                DrawTextureEx(player.texture, {player.position.x + player.bounds.width, player.position.y}, 0.0f, -baseScale, playerColor);
+            // Draw player with appropriate direction (a negative source width mirrors the sprite)
+            Rectangle source = playerFrame.source;
+            if (!player.isFacingRight) {
+                source.width = -source.width;
             }
+            Rectangle dest = {playerPosition.x, playerPosition.y,
+                              playerFrame.sourceSize.x * baseScale, playerFrame.sourceSize.y * baseScale};
+            DrawTexturePro(atlas.texture, source, dest, {0, 0}, 0.0f, playerColor);
         }
         
-        // Draw bat enemy (if active)
-        if (bat.active) {
+        // The other racer is a translucent ghost; they do not collide with this player
+        if (snapshot.versus) {
+            Rectangle source = playerFrame.source;
+            if (!snapshot.rival.isFacingRight) {
+                source.width = -source.width;
+            }
+            Rectangle dest = {snapshot.rival.position.x, snapshot.rival.position.y,
+                              playerFrame.sourceSize.x * batScale, playerFrame.sourceSize.y * batScale};
+            DrawTexturePro(atlas.texture, source, dest, {0, 0}, 0.0f, Fade(ORANGE, 0.5f));
+        }
+        
+        // Draw bat enemies (all share the same eight frame textures)
+        for (int i = 0; i < bats.count; i++) {
+            Rectangle batBounds = GetBatBounds(bats, i);
+            if (i < static_cast<int>(previousPositions.batX.size())) {
+                Vector2 batPosition = InterpolatePosition({previousPositions.batX[i], previousPositions.batY[i]},
+                                                          {batBounds.x, batBounds.y}, alpha);
+                batBounds.x = batPosition.x;
+                batBounds.y = batPosition.y;
+            }
             if (usingBatFallback) {
                 // Draw a more visible bat if using fallback
-                DrawRectangle(bat.position.x, bat.position.y, bat.bounds.width, bat.bounds.height, RED);
-                DrawRectangleLines(bat.position.x, bat.position.y, bat.bounds.width, bat.bounds.height, BLACK);
+                DrawRectangle(batBounds.x, batBounds.y, batBounds.width, batBounds.height, RED);
+                DrawRectangleLines(batBounds.x, batBounds.y, batBounds.width, batBounds.height, BLACK);
             } else {
                 // Draw the current animation frame
-                DrawTextureEx(bat.frames[bat.currentFrame], bat.position, 0.0f, bat.scale, WHITE);
+                DrawTexturePro(atlas.texture, batFrames[bats.currentFrame[i]], batBounds, {0, 0}, 0.0f, WHITE);
             }
             
             // Draw debug info for bat bounds
-            DrawRectangleLines(bat.bounds.x, bat.bounds.y, bat.bounds.width, bat.bounds.height, PURPLE);
+            DrawRectangleLines(batBounds.x, batBounds.y, batBounds.width, batBounds.height, PURPLE);
         }
         
-        // Draw game info
-        DrawText("Arrow Keys: Move | Space/Up: Jump", 20, 20, 20, BLACK);
-        
-        // Draw debug info about the player texture
-        char debugInfo[100];
-        sprintf(debugInfo, "Player Texture: %dx%d", player.texture.width, player.texture.height);
-        DrawText(debugInfo, 20, 50, 20, RED);
+        EndMode2D();
+        EndProfileZone(PROFILE_DRAW_SPRITES, zoneStart);
+        zoneStart = BeginProfileZone();
         
-        // Draw jump state debug info
-        char jumpInfo[200];
-        sprintf(jumpInfo, "Jump: %s | Velocity Y: %.1f | Coyote: %d | Buffer: %d", 
-                player.isJumping ? "YES" : "NO", 
-                player.velocity.y,
-                player.coyoteTimer,
-                player.jumpBufferTimer);
-        DrawText(jumpInfo, 20, 80, 20, DARKGREEN);
+        // HUD text comes from cached textures; labels follow the flag and player on screen
+        DrawHud(hud, flag.reached, {flag.position.x - cameraX - 50, flag.position.y - 30},
+                player.invulnerabilityTimer > 0, {playerPosition.x - cameraX, playerPosition.y - 20},
+                snapshot.levelComplete);
 
-        // Draw score
-        char scoreText[100];
-        sprintf(scoreText, "BAT: %d | PLAYER: %d", score.bat, score.player);
-        DrawText(scoreText, screenWidth - 250, 20, 20, BLACK);
-        
-        // Draw flag status if reached
-        if (flag.reached) {
-            DrawText("FLAG REACHED!", flag.position.x - 50, flag.position.y - 30, 16, GREEN);
-        }
-        
-        // Draw invulnerability status if active
-        if (player.invulnerabilityTimer > 0) {
-            DrawText("INVULNERABLE!", player.position.x, player.position.y - 20, 16, YELLOW);
-        }
-
-        // Draw game over screen if flag is reached
-        if (gameOver) {
-            // Draw semi-transparent overlay
-            DrawRectangle(0, 0, screenWidth, screenHeight, Fade(BLACK, 0.7f));
-            
-            // Draw "YOU WIN FREER" text
-            const char* winText = "YOU WIN FREER";
-            int fontSize = 60;
-            int textWidth = MeasureText(winText, fontSize);
-            DrawText(winText, screenWidth/2 - textWidth/2, screenHeight/2 - fontSize/2, fontSize, YELLOW);
-            
-            // Draw instruction to exit
-            const char* exitText = "Press ESC to exit";
-            int smallFontSize = 30;
-            int smallTextWidth = MeasureText(exitText, smallFontSize);
-            DrawText(exitText, screenWidth/2 - smallTextWidth/2, screenHeight/2 + fontSize, smallFontSize, WHITE);
+        if (showProfiler) {
+            DrawProfilerOverlay(screenWidth - 590, 50);
         }
+        EndProfileZone(PROFILE_DRAW_HUD, zoneStart);
 
+        zoneStart = BeginProfileZone();
         EndDrawing();
+        EndProfileZone(PROFILE_PRESENT, zoneStart);
+        EndProfilerFrame();
     }
 
-    // De-initialization
-    UnloadTexture(playerTexture);
-    UnloadTexture(groundTexture);
-    UnloadTexture(backgroundTexture);
-    UnloadTexture(flagTexture);
-    
-    // Unload all bat animation frames
-    if (!usingBatFallback) {
-        for (int i = 0; i < 8; i++) {
-            UnloadTexture(bat.frames[i]);
+    StopSimThread(sim);
+    if (versus) {
+        CloseNetPeer(netPeer);
+    }
+    if (!recordPath.empty()) {
+        recording.finalHash = HashGameState(state);
+        if (SaveInputRecording(recording, recordPath)) {
+            std::cout << "Recorded " << recording.buttons.size() << " ticks to " << recordPath << std::endl;
+        } else {
+            std::cout << "Failed to write recording " << recordPath << std::endl;
         }
-    } else {
-        UnloadTexture(batTexture);
     }
     
-    // Unload music if loaded
-    if (musicLoaded) {
-        UnloadMusicStream(gameMusic);
-    }
+    // De-initialization
+    UnloadTilemap(tilemap);
+    UnloadHud(hud);
+    StopAudio(audio);
+    UnloadGameAssets(assets);
+    EndLevelSequence(sequence);
+    CloseLevelFile(levelFile);
     
     CloseAudioDevice();
     CloseWindow();
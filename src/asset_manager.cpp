@@ -0,0 +1,411 @@
+#include "asset_manager.h"
+#include "game.h"
+#include "parallel.h"
+#include "procedural_image.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// assets.pak layout: PakHeader, PakEntry[entryCount], then each entry's bytes
+// at a 64-byte aligned offset. Images are raw RGBA8 pixels ready for upload;
+// blobs are opaque bytes (frame table text, manifest, a WAV file).
+static const char pakMagic[4] = {'F', 'T', 'P', 'K'};
+static const uint32_t pakVersion = 2;
+static const uint64_t pakAlignment = 64;
+
+enum PakEntryKind : uint32_t {
+    PAK_IMAGE = 1,
+    PAK_BLOB = 2
+};
+
+struct PakHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct PakEntry {
+    char name[32];
+    uint32_t kind;
+    uint32_t width;   // Images only
+    uint32_t height;
+    uint32_t format;  // raylib PixelFormat
+    uint64_t offset;  // From the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(PakHeader) == 16, "PakHeader layout is part of the file format");
+static_assert(sizeof(PakEntry) == 64, "PakEntry layout is part of the file format");
+
+// Entry queued for writing
+struct PakItem {
+    PakEntry entry;
+    const void* data;
+};
+
+// How long one asset took, for the startup report
+struct AssetTiming {
+    std::string name;
+    std::string source; // "pak", "file" or "generated"
+    double decodeMs;
+    double uploadMs;
+};
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static PakItem MakePakItem(const char* name, uint32_t kind, const void* data, uint64_t size,
+                           int width = 0, int height = 0, int format = 0) {
+    PakItem item = {};
+    strncpy(item.entry.name, name, sizeof(item.entry.name) - 1);
+    item.entry.kind = kind;
+    item.entry.width = static_cast<uint32_t>(width);
+    item.entry.height = static_cast<uint32_t>(height);
+    item.entry.format = static_cast<uint32_t>(format);
+    item.entry.size = size;
+    item.data = data;
+    return item;
+}
+
+// Write to a temporary file and rename, so a crash never leaves a truncated pak behind
+static bool WriteAssetPak(const std::string& path, std::vector<PakItem>& items) {
+    uint64_t offset = sizeof(PakHeader) + items.size() * sizeof(PakEntry);
+    for (auto& item : items) {
+        offset = (offset + pakAlignment - 1) / pakAlignment * pakAlignment;
+        item.entry.offset = offset;
+        offset += item.entry.size;
+    }
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        PakHeader header = {};
+        memcpy(header.magic, pakMagic, sizeof(pakMagic));
+        header.version = pakVersion;
+        header.entryCount = static_cast<uint32_t>(items.size());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& item : items) {
+            out.write(reinterpret_cast<const char*>(&item.entry), sizeof(item.entry));
+        }
+        static const char zeros[pakAlignment] = {};
+        for (const auto& item : items) {
+            uint64_t position = static_cast<uint64_t>(out.tellp());
+            out.write(zeros, static_cast<std::streamsize>(item.entry.offset - position));
+            out.write(static_cast<const char*>(item.data), static_cast<std::streamsize>(item.entry.size));
+        }
+        if (!out) return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// Entry by name with its bytes bounds-checked against the mapping, or nullptr
+static const PakEntry* FindPakEntry(const MappedFile& pak, const char* name) {
+    const PakHeader* header = reinterpret_cast<const PakHeader*>(pak.data);
+    const PakEntry* entries = reinterpret_cast<const PakEntry*>(pak.data + sizeof(PakHeader));
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        if (strncmp(entries[i].name, name, sizeof(entries[i].name)) == 0) {
+            const PakEntry& entry = entries[i];
+            if (entry.offset > pak.size || entry.size > pak.size - entry.offset) return nullptr;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+static bool IsValidPak(const MappedFile& pak) {
+    if (pak.size < sizeof(PakHeader)) return false;
+    const PakHeader* header = reinterpret_cast<const PakHeader*>(pak.data);
+    return memcmp(header->magic, pakMagic, sizeof(pakMagic)) == 0 && header->version == pakVersion &&
+           sizeof(PakHeader) + static_cast<uint64_t>(header->entryCount) * sizeof(PakEntry) <= pak.size;
+}
+
+// Whether an image entry's bytes hold all of its pixels in a format raylib knows,
+// so uploading it cannot read past the entry (and the mapping)
+static bool IsValidPakImage(const PakEntry& entry) {
+    const uint32_t maxSide = 16384; // Keeps GetPixelDataSize's int arithmetic from overflowing
+    if (entry.width == 0 || entry.height == 0 || entry.width > maxSide || entry.height > maxSide) return false;
+    if (entry.format < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE || entry.format > PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA) {
+        return false;
+    }
+    int pixelBytes = GetPixelDataSize(static_cast<int>(entry.width), static_cast<int>(entry.height),
+                                      static_cast<int>(entry.format));
+    return pixelBytes > 0 && static_cast<uint64_t>(pixelBytes) <= entry.size;
+}
+
+// Non-owning Image over pixels inside the mapping (must not be unloaded); check IsValidPakImage first
+static Image PakImage(const MappedFile& pak, const PakEntry& entry) {
+    return {const_cast<unsigned char*>(pak.data + entry.offset), static_cast<int>(entry.width),
+            static_cast<int>(entry.height), 1, static_cast<int>(entry.format)};
+}
+
+// Identifies the sources the pak was built from; any change forces a rebuild
+static std::string BuildManifest(const AssetPaths& paths) {
+    std::string manifest = "findtreasure asset sources\n";
+    auto addSource = [&](const std::string& label, const std::string& path) {
+        bool exists = FileExists(path.c_str());
+        manifest += label + "\t" + path + "\t" + (exists ? std::to_string(GetFileModTime(path.c_str())) : "-") + "\n";
+    };
+    for (const auto& sprite : paths.sprites) {
+        addSource(sprite.name + "@" + std::to_string(sprite.packScale), sprite.path);
+    }
+    addSource("background", paths.background);
+    addSource("music", paths.music);
+    addSource("bonus", paths.bonusSound);
+    return manifest;
+}
+
+// Gradient from sky blue (top) to white, used when there is no background image
+static Image GenerateGradientBackground() {
+    return GenImageVerticalGradient(screenWidth, screenHeight, SKYBLUE, WHITE);
+}
+
+// For each sprite, the index of an earlier sprite whose generated placeholder is
+// identical (same size and color), or -1. Those are generated and packed once.
+static std::vector<int> FindSharedPlaceholders(const std::vector<AtlasSprite>& sprites) {
+    std::vector<int> sharedWith(sprites.size(), -1);
+    std::vector<bool> missing(sprites.size());
+    for (size_t i = 0; i < sprites.size(); i++) {
+        missing[i] = !FileExists(sprites[i].path.c_str());
+        if (!missing[i]) continue;
+        PlaceholderKey key = {sprites[i].fallbackWidth, sprites[i].fallbackHeight, sprites[i].fallbackColor};
+        for (size_t j = 0; j < i; j++) {
+            PlaceholderKey other = {sprites[j].fallbackWidth, sprites[j].fallbackHeight, sprites[j].fallbackColor};
+            if (missing[j] && sharedWith[j] < 0 && SamePlaceholder(key, other)) {
+                sharedWith[i] = static_cast<int>(j);
+                break;
+            }
+        }
+    }
+    return sharedWith;
+}
+
+// Complete 16-bit PCM WAV file, so the music can stream from memory without MP3 decoding
+static std::vector<unsigned char> EncodeWav(Wave wave) {
+    WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+    uint32_t dataSize = wave.frameCount * wave.channels * 2;
+    uint32_t byteRate = wave.sampleRate * wave.channels * 2;
+    uint16_t blockAlign = static_cast<uint16_t>(wave.channels * 2);
+    uint16_t pcm = 1, channels = static_cast<uint16_t>(wave.channels), bits = 16;
+    uint32_t riffSize = 36 + dataSize, fmtSize = 16;
+
+    std::vector<unsigned char> wav(44 + dataSize);
+    unsigned char* p = wav.data();
+    auto put = [&p](const void* data, size_t size) { memcpy(p, data, size); p += size; };
+    put("RIFF", 4); put(&riffSize, 4); put("WAVE", 4);
+    put("fmt ", 4); put(&fmtSize, 4); put(&pcm, 2); put(&channels, 2);
+    put(&wave.sampleRate, 4); put(&byteRate, 4); put(&blockAlign, 2); put(&bits, 2);
+    put("data", 4); put(&dataSize, 4); put(wave.data, dataSize);
+    UnloadWave(wave);
+    return wav;
+}
+
+static WavBytes PakWav(const MappedFile& pak, const char* name) {
+    const PakEntry* entry = FindPakEntry(pak, name);
+    if (entry == nullptr) return {nullptr, 0};
+    return {pak.data + entry->offset, static_cast<size_t>(entry->size)};
+}
+
+static WavBytes OwnedWav(const std::vector<unsigned char>& wav) {
+    if (wav.empty()) return {nullptr, 0};
+    return {wav.data(), wav.size()};
+}
+
+// True if the frame table has an entry for every sprite the game will look up
+static bool HasAllSpriteFrames(const std::vector<AtlasFrame>& frames, const AssetPaths& paths) {
+    for (const AtlasSprite& sprite : paths.sprites) {
+        bool found = false;
+        for (const AtlasFrame& frame : frames) {
+            if (frame.name == sprite.name) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// Fast path: everything comes pre-decoded from the mapped pak
+static bool LoadFromPak(GameAssets& assets, const AssetPaths& paths, std::vector<AssetTiming>& timings) {
+    auto start = std::chrono::steady_clock::now();
+    if (!OpenMappedFile(assets.pak, paths.pak)) return false;
+    if (!IsValidPak(assets.pak)) {
+        std::cout << "Ignoring invalid asset pak: " << paths.pak << std::endl;
+        CloseMappedFile(assets.pak);
+        return false;
+    }
+    const PakEntry* manifest = FindPakEntry(assets.pak, "manifest");
+    const PakEntry* atlas = FindPakEntry(assets.pak, "atlas");
+    const PakEntry* frames = FindPakEntry(assets.pak, "atlas.frames");
+    const PakEntry* background = FindPakEntry(assets.pak, "background");
+    std::vector<AtlasFrame> atlasFrames;
+    if (manifest == nullptr || atlas == nullptr || frames == nullptr || background == nullptr ||
+        !IsValidPakImage(*atlas) || !IsValidPakImage(*background) ||
+        std::string(reinterpret_cast<const char*>(assets.pak.data + manifest->offset), manifest->size) != BuildManifest(paths) ||
+        !ParseAtlasFrames(std::string(reinterpret_cast<const char*>(assets.pak.data + frames->offset), frames->size), atlasFrames) ||
+        !HasAllSpriteFrames(atlasFrames, paths)) {
+        std::cout << "Asset pak missing or out of date: " << paths.pak << std::endl;
+        CloseMappedFile(assets.pak);
+        return false;
+    }
+    timings.push_back({"assets.pak", "pak", MillisecondsSince(start), 0.0});
+
+    start = std::chrono::steady_clock::now();
+    assets.atlas.texture = LoadTextureFromImage(PakImage(assets.pak, *atlas));
+    assets.atlas.frames = atlasFrames;
+    timings.push_back({"atlas", "pak", 0.0, MillisecondsSince(start)});
+
+    start = std::chrono::steady_clock::now();
+    assets.background = LoadTextureFromImage(PakImage(assets.pak, *background));
+    timings.push_back({"background", "pak", 0.0, MillisecondsSince(start)});
+
+    assets.music = PakWav(assets.pak, "music");
+    assets.bonus = PakWav(assets.pak, "bonus");
+    return true;
+}
+
+// Slow path: decode sources on the worker pool, upload here, then write the pak
+static void LoadFromSources(GameAssets& assets, const AssetPaths& paths, std::vector<AssetTiming>& timings) {
+    const int spriteCount = static_cast<int>(paths.sprites.size());
+    std::vector<Image> spriteImages(spriteCount);
+    std::vector<AtlasFrame> frames(spriteCount);
+    std::vector<int> sharedWith = FindSharedPlaceholders(paths.sprites);
+    std::vector<double> decodeMs(spriteCount + 3);
+    Image backgroundImg = {};
+    bool backgroundFromFile = FileExists(paths.background.c_str());
+    bool musicFromFile = FileExists(paths.music.c_str());
+    bool bonusFromFile = FileExists(paths.bonusSound.c_str());
+
+    // Jobs: one per sprite, then the background, the music and the bonus sound
+    ParallelFor(spriteCount + 3, 0, [&](int job) {
+        auto start = std::chrono::steady_clock::now();
+        if (job < spriteCount) {
+            if (sharedWith[job] < 0) {
+                spriteImages[job] = DecodeAtlasSprite(paths.sprites[job], frames[job]);
+            }
+        } else if (job == spriteCount) {
+            if (backgroundFromFile) {
+                backgroundImg = LoadImage(paths.background.c_str());
+                ImageFormat(&backgroundImg, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            } else {
+                backgroundImg = GenerateGradientBackground();
+            }
+        } else if (job == spriteCount + 1) {
+            if (musicFromFile) assets.musicWav = EncodeWav(LoadWave(paths.music.c_str()));
+        } else if (bonusFromFile) {
+            assets.bonusWav = EncodeWav(LoadWave(paths.bonusSound.c_str()));
+        }
+        decodeMs[job] = MillisecondsSince(start);
+    });
+
+    for (int i = 0; i < spriteCount; i++) {
+        const char* source = (sharedWith[i] >= 0) ? "shared" : frames[i].fromFile ? "file" : "generated";
+        timings.push_back({paths.sprites[i].name, source, decodeMs[i], 0.0});
+    }
+
+    // Pack only the unique images, then point shared placeholders at their original's rect
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Image> uniqueImages;
+    std::vector<AtlasFrame> uniqueFrames;
+    for (int i = 0; i < spriteCount; i++) {
+        if (sharedWith[i] < 0) {
+            uniqueImages.push_back(spriteImages[i]);
+            uniqueFrames.push_back(frames[i]);
+        }
+    }
+    Image atlasImage = PackAtlasImage(uniqueImages, uniqueFrames);
+    for (int i = 0, unique = 0; i < spriteCount; i++) {
+        if (sharedWith[i] < 0) {
+            frames[i] = uniqueFrames[unique++];
+        } else {
+            frames[i] = frames[sharedWith[i]];
+            frames[i].name = paths.sprites[i].name;
+        }
+    }
+    double packMs = MillisecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    assets.atlas.texture = LoadTextureFromImage(atlasImage);
+    assets.atlas.frames = frames;
+    timings.push_back({"atlas", "generated", packMs, MillisecondsSince(start)});
+
+    start = std::chrono::steady_clock::now();
+    assets.background = LoadTextureFromImage(backgroundImg);
+    timings.push_back({"background", backgroundFromFile ? "file" : "generated", decodeMs[spriteCount],
+                       MillisecondsSince(start)});
+
+    assets.music = OwnedWav(assets.musicWav);
+    assets.bonus = OwnedWav(assets.bonusWav);
+    if (assets.music.data != nullptr) {
+        timings.push_back({"music", "file", decodeMs[spriteCount + 1], 0.0});
+    } else {
+        std::cout << "Music file not found at: " << paths.music << std::endl;
+    }
+    if (assets.bonus.data != nullptr) {
+        timings.push_back({"bonus", "file", decodeMs[spriteCount + 2], 0.0});
+    } else {
+        std::cout << "Bonus sound not found at: " << paths.bonusSound << std::endl;
+    }
+
+    // Pre-decoded bundle for the next start; failure (e.g. read-only install) is not an error
+    start = std::chrono::steady_clock::now();
+    std::string manifest = BuildManifest(paths);
+    std::string frameTable = SerializeAtlasFrames(frames);
+    std::vector<PakItem> items = {
+        MakePakItem("manifest", PAK_BLOB, manifest.data(), manifest.size()),
+        MakePakItem("atlas", PAK_IMAGE, atlasImage.data,
+                    static_cast<uint64_t>(atlasImage.width) * atlasImage.height * 4,
+                    atlasImage.width, atlasImage.height, atlasImage.format),
+        MakePakItem("atlas.frames", PAK_BLOB, frameTable.data(), frameTable.size()),
+        MakePakItem("background", PAK_IMAGE, backgroundImg.data,
+                    static_cast<uint64_t>(backgroundImg.width) * backgroundImg.height * 4,
+                    backgroundImg.width, backgroundImg.height, backgroundImg.format)
+    };
+    if (!assets.musicWav.empty()) {
+        items.push_back(MakePakItem("music", PAK_BLOB, assets.musicWav.data(), assets.musicWav.size()));
+    }
+    if (!assets.bonusWav.empty()) {
+        items.push_back(MakePakItem("bonus", PAK_BLOB, assets.bonusWav.data(), assets.bonusWav.size()));
+    }
+    if (WriteAssetPak(paths.pak, items)) {
+        timings.push_back({"assets.pak (write)", "generated", MillisecondsSince(start), 0.0});
+    } else {
+        std::cout << "Could not write asset pak: " << paths.pak << std::endl;
+    }
+
+    UnloadImage(atlasImage);
+    UnloadImage(backgroundImg);
+}
+
+void LoadGameAssets(GameAssets& assets, const AssetPaths& paths) {
+    assets.music = {nullptr, 0};
+    assets.bonus = {nullptr, 0};
+    std::vector<AssetTiming> timings;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!LoadFromPak(assets, paths, timings)) {
+        LoadFromSources(assets, paths, timings);
+    }
+
+    std::cout << "Asset load times:" << std::endl;
+    for (const auto& timing : timings) {
+        char line[160];
+        snprintf(line, sizeof(line), "  %-20s %-10s decode %8.2f ms  upload %8.2f ms",
+                 timing.name.c_str(), timing.source.c_str(), timing.decodeMs, timing.uploadMs);
+        std::cout << line << std::endl;
+    }
+    std::cout << "  total " << MillisecondsSince(start) << " ms" << std::endl;
+}
+
+void UnloadGameAssets(GameAssets& assets) {
+    UnloadTextureAtlas(assets.atlas);
+    UnloadTexture(assets.background);
+    CloseMappedFile(assets.pak);
+    assets.musicWav.clear();
+    assets.bonusWav.clear();
+    assets.music = {nullptr, 0};
+    assets.bonus = {nullptr, 0};
+}
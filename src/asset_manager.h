@@ -0,0 +1,43 @@
+#pragma once
+
+#include "mapped_file.h"
+#include "raylib.h"
+#include "texture_atlas.h"
+#include <string>
+#include <vector>
+
+// Where the game's source assets live and where the pre-decoded bundle goes
+struct AssetPaths {
+    std::vector<AtlasSprite> sprites; // Packed into the texture atlas
+    std::string background;           // Optional; a gradient is generated when missing
+    std::string music;                // Optional
+    std::string bonusSound;           // Optional; played when the flag is reached
+    std::string pak;                  // Pre-decoded bundle (assets.pak)
+};
+
+// A 16-bit PCM WAV file in memory (inside the pak or one of GameAssets' vectors);
+// data is null when the source file is missing
+struct WavBytes {
+    const unsigned char* data;
+    size_t size;
+};
+
+// Everything the renderer and audio need, loaded once at startup
+struct GameAssets {
+    TextureAtlas atlas;
+    Texture2D background;
+    WavBytes music;
+    WavBytes bonus;
+    MappedFile pak;                      // Kept mapped: the music streams straight from it
+    std::vector<unsigned char> musicWav; // Music bytes when the pak could not be used
+    std::vector<unsigned char> bonusWav;
+};
+
+// Load all assets. When assets.pak is present and matches the source files it is
+// memory-mapped and uploaded with no PNG/MP3 decoding; otherwise the sources are
+// decoded on a worker pool, uploaded on this (the GL) thread and the pak is
+// rewritten for next time. Sounds are left as WAV bytes for StartAudio. Prints
+// per-asset load times.
+void LoadGameAssets(GameAssets& assets, const AssetPaths& paths);
+
+void UnloadGameAssets(GameAssets& assets);
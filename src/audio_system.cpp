@@ -0,0 +1,219 @@
+#include "audio_system.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// The device callback has no user pointer, so it finds the playing ring here
+static AudioRing* musicRing = nullptr;
+static std::atomic<uint32_t>* musicUnderruns = nullptr;
+
+AudioSettings DefaultAudioSettings() {
+    AudioSettings settings;
+    settings.musicBufferMs = 500;
+    settings.updateMs = 10;
+    settings.voicesPerEffect = 4;
+    settings.musicVolume = 0.5f; // 50% volume
+    settings.effectVolume = 0.8f;
+    return settings;
+}
+
+// 16-bit PCM samples of a WAV file, pointing into the file's bytes
+struct PcmWav {
+    const int16_t* frames;
+    size_t frameCount;
+    int channels;
+    int sampleRate;
+};
+
+static bool ParsePcmWav(const unsigned char* data, size_t size, PcmWav& wav) {
+    if (data == nullptr || size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t sampleRate = 0;
+    const unsigned char* samples = nullptr;
+    uint32_t samplesSize = 0;
+    for (size_t offset = 12; offset + 8 <= size;) {
+        uint32_t chunkSize;
+        memcpy(&chunkSize, data + offset + 4, 4);
+        const unsigned char* body = data + offset + 8;
+        if (chunkSize > size - offset - 8) return false;
+        if (memcmp(data + offset, "fmt ", 4) == 0 && chunkSize >= 16) {
+            memcpy(&format, body, 2);
+            memcpy(&channels, body + 2, 2);
+            memcpy(&sampleRate, body + 4, 4);
+            memcpy(&bits, body + 14, 2);
+        } else if (memcmp(data + offset, "data", 4) == 0) {
+            samples = body;
+            samplesSize = chunkSize;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    if (format != 1 || bits != 16 || channels < 1 || channels > 2 || samples == nullptr ||
+        reinterpret_cast<uintptr_t>(samples) % alignof(int16_t) != 0) {
+        return false;
+    }
+    wav.frames = reinterpret_cast<const int16_t*>(samples);
+    wav.frameCount = samplesSize / (2 * channels);
+    wav.channels = channels;
+    wav.sampleRate = static_cast<int>(sampleRate);
+    return wav.frameCount > 0;
+}
+
+// Runs on the audio device's thread: hand over what the ring has, silence for the rest
+static void MusicCallback(void* buffer, unsigned int frames) {
+    AudioRing& ring = *musicRing;
+    int16_t* out = static_cast<int16_t*>(buffer);
+    uint64_t read = ring.read.load(std::memory_order_relaxed);
+    uint64_t available = ring.written.load(std::memory_order_acquire) - read;
+    size_t count = static_cast<size_t>(std::min<uint64_t>(frames, available));
+    for (size_t done = 0; done < count;) {
+        size_t slot = (read + done) % ring.capacity;
+        size_t run = std::min(count - done, ring.capacity - slot);
+        memcpy(out + done * ring.channels, &ring.samples[slot * ring.channels], run * ring.channels * sizeof(int16_t));
+        done += run;
+    }
+    if (count < frames) {
+        memset(out + count * ring.channels, 0, (frames - count) * ring.channels * sizeof(int16_t));
+        musicUnderruns->fetch_add(1, std::memory_order_relaxed);
+    }
+    ring.read.store(read + count, std::memory_order_release);
+}
+
+// Top the ring up from the music, looping at its end
+static void FillMusicRing(AudioSystem& audio) {
+    AudioRing& ring = audio.ring;
+    uint64_t written = ring.written.load(std::memory_order_relaxed);
+    size_t space = ring.capacity - static_cast<size_t>(written - ring.read.load(std::memory_order_acquire));
+    while (space > 0) {
+        size_t slot = written % ring.capacity;
+        size_t run = std::min({space, ring.capacity - slot, audio.musicFrameCount - audio.musicCursor});
+        memcpy(&ring.samples[slot * ring.channels], audio.musicFrames + audio.musicCursor * ring.channels,
+               run * ring.channels * sizeof(int16_t));
+        written += run;
+        space -= run;
+        audio.musicCursor += run;
+        if (audio.musicCursor == audio.musicFrameCount) audio.musicCursor = 0;
+    }
+    ring.written.store(written, std::memory_order_release);
+}
+
+// Start each queued effect on the next voice of its pool; with every voice
+// busy, the one started longest ago is cut off
+static void StartPendingEffects(AudioSystem& audio) {
+    for (int effect = 0; effect < SFX_COUNT; effect++) {
+        uint32_t count = audio.pending[effect].exchange(0, std::memory_order_acquire);
+        if (!audio.effectLoaded[effect]) continue;
+        count = std::min<uint32_t>(count, audio.settings.voicesPerEffect);
+        for (uint32_t i = 0; i < count; i++) {
+            PlaySound(audio.voices[effect][audio.nextVoice[effect]]);
+            audio.nextVoice[effect] = (audio.nextVoice[effect] + 1) % audio.settings.voicesPerEffect;
+        }
+    }
+}
+
+static void RunAudioThread(AudioSystem& audio) {
+    while (audio.running.load(std::memory_order_acquire)) {
+        if (audio.musicLoaded) FillMusicRing(audio);
+        StartPendingEffects(audio);
+        std::this_thread::sleep_for(std::chrono::milliseconds(audio.settings.updateMs));
+    }
+}
+
+// Short falling square-wave blip for the bat hit; there is no sound file for it
+static Wave GenerateHitWave() {
+    const int sampleRate = 44100;
+    const int frameCount = sampleRate * 3 / 20; // 150 ms
+    int16_t* samples = static_cast<int16_t*>(MemAlloc(frameCount * sizeof(int16_t)));
+    float phase = 0;
+    for (int i = 0; i < frameCount; i++) {
+        float t = static_cast<float>(i) / frameCount;
+        phase += (880.0f - 600.0f * t) / sampleRate;
+        phase -= floorf(phase);
+        samples[i] = static_cast<int16_t>((phase < 0.5f ? 1.0f : -1.0f) * (1.0f - t) * 0.3f * 32767.0f);
+    }
+    return {static_cast<unsigned int>(frameCount), sampleRate, 16, 1, samples};
+}
+
+static void LoadEffect(AudioSystem& audio, SoundEffect effect, Wave wave) {
+    audio.effectLoaded[effect] = wave.frameCount > 0;
+    if (!audio.effectLoaded[effect]) return;
+    audio.effects[effect] = LoadSoundFromWave(wave);
+    for (int i = 0; i < audio.settings.voicesPerEffect; i++) {
+        audio.voices[effect][i] = LoadSoundAlias(audio.effects[effect]);
+        SetSoundVolume(audio.voices[effect][i], audio.settings.effectVolume);
+    }
+}
+
+void StartAudio(AudioSystem& audio, const AudioSettings& settings, const unsigned char* musicWav,
+                size_t musicWavSize, const unsigned char* bonusWav, size_t bonusWavSize) {
+    audio.settings = settings;
+    audio.settings.voicesPerEffect = std::max(1, std::min(settings.voicesPerEffect, maxSoundVoices));
+    audio.underruns.store(0);
+
+    // Effects are decoded here, once
+    for (int effect = 0; effect < SFX_COUNT; effect++) {
+        audio.pending[effect].store(0);
+        audio.nextVoice[effect] = 0;
+        audio.effectLoaded[effect] = false;
+    }
+    if (bonusWav != nullptr && bonusWavSize > 0) {
+        Wave bonus = LoadWaveFromMemory(".wav", bonusWav, static_cast<int>(bonusWavSize));
+        LoadEffect(audio, SFX_FLAG, bonus);
+        UnloadWave(bonus);
+    }
+    Wave hit = GenerateHitWave();
+    LoadEffect(audio, SFX_BAT_HIT, hit);
+    UnloadWave(hit);
+
+    // Music: fill the whole ring before the device starts pulling from it
+    PcmWav music;
+    audio.musicLoaded = ParsePcmWav(musicWav, musicWavSize, music);
+    if (audio.musicLoaded) {
+        audio.musicFrames = music.frames;
+        audio.musicFrameCount = music.frameCount;
+        audio.musicCursor = 0;
+        AudioRing& ring = audio.ring;
+        ring.channels = music.channels;
+        ring.capacity = std::max<size_t>(1, static_cast<size_t>(music.sampleRate) * settings.musicBufferMs / 1000);
+        ring.samples.assign(ring.capacity * ring.channels, 0);
+        ring.written.store(0);
+        ring.read.store(0);
+        FillMusicRing(audio);
+
+        musicRing = &audio.ring;
+        musicUnderruns = &audio.underruns;
+        audio.musicStream = LoadAudioStream(music.sampleRate, 16, music.channels);
+        SetAudioStreamCallback(audio.musicStream, MusicCallback);
+        SetAudioStreamVolume(audio.musicStream, settings.musicVolume);
+        PlayAudioStream(audio.musicStream);
+    }
+
+    audio.running.store(true, std::memory_order_release);
+    audio.thread = std::thread(RunAudioThread, std::ref(audio));
+}
+
+void TriggerSoundEffect(AudioSystem& audio, SoundEffect effect) {
+    audio.pending[effect].fetch_add(1, std::memory_order_release);
+}
+
+void StopAudio(AudioSystem& audio) {
+    audio.running.store(false, std::memory_order_release);
+    if (audio.thread.joinable()) audio.thread.join();
+    if (audio.musicLoaded) {
+        StopAudioStream(audio.musicStream);
+        UnloadAudioStream(audio.musicStream);
+        musicRing = nullptr;
+        musicUnderruns = nullptr;
+        audio.musicLoaded = false;
+    }
+    for (int effect = 0; effect < SFX_COUNT; effect++) {
+        if (!audio.effectLoaded[effect]) continue;
+        for (int i = 0; i < audio.settings.voicesPerEffect; i++) {
+            UnloadSoundAlias(audio.voices[effect][i]);
+        }
+        UnloadSound(audio.effects[effect]);
+        audio.effectLoaded[effect] = false;
+    }
+}
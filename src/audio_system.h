@@ -0,0 +1,78 @@
+#pragma once
+
+#include "raylib.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Sounds the game triggers
+enum SoundEffect {
+    SFX_FLAG,    // Flag reached (game-bonus.mp3)
+    SFX_BAT_HIT, // A bat hit the player (generated blip)
+    SFX_COUNT
+};
+
+const int maxSoundVoices = 8; // Most copies of one effect that can play at once
+
+// Knobs for StartAudio; DefaultAudioSettings gives the game's values
+struct AudioSettings {
+    int musicBufferMs;   // Music kept decoded ahead of the audio device; a hitch this long is inaudible
+    int updateMs;        // How often the audio thread tops up the buffer and starts queued effects
+    int voicesPerEffect; // Up to maxSoundVoices
+    float musicVolume;
+    float effectVolume;
+};
+
+AudioSettings DefaultAudioSettings();
+
+// Single-producer single-consumer ring of interleaved 16-bit frames. Positions
+// only ever grow; the slot is position % capacity.
+struct AudioRing {
+    std::vector<int16_t> samples;
+    size_t capacity;             // In frames
+    int channels;
+    std::atomic<uint64_t> written;
+    std::atomic<uint64_t> read;
+};
+
+// Music streaming and sound effects off the game thread. The audio thread
+// copies music from the in-memory WAV (the mapped asset pak) into the ring;
+// the audio device's callback drains it. Effects are loaded once, each with a
+// pool of voices sharing its samples, so triggering one is an atomic increment
+// and starting it never decodes or allocates.
+struct AudioSystem {
+    AudioSettings settings;
+
+    // Music: 16-bit PCM frames inside a WAV file (not owned)
+    const int16_t* musicFrames;
+    size_t musicFrameCount;
+    size_t musicCursor;        // Next frame to copy into the ring (audio thread only)
+    AudioStream musicStream;
+    bool musicLoaded;
+    AudioRing ring;
+    std::atomic<uint32_t> underruns; // Device callbacks that found the ring short
+
+    Sound effects[SFX_COUNT];
+    Sound voices[SFX_COUNT][maxSoundVoices]; // Aliases of effects[i] sharing its samples
+    bool effectLoaded[SFX_COUNT];
+    int nextVoice[SFX_COUNT];
+    std::atomic<uint32_t> pending[SFX_COUNT]; // Triggered, not started yet
+
+    std::atomic<bool> running;
+    std::thread thread;
+};
+
+// Load the music and effects (16-bit PCM WAV files in memory; null or empty
+// ones are skipped, and a blip is generated for the bat hit), fill the ring and
+// start the audio thread. Needs InitAudioDevice. music must stay valid until
+// StopAudio. Only one AudioSystem can play music at a time.
+void StartAudio(AudioSystem& audio, const AudioSettings& settings, const unsigned char* musicWav,
+                size_t musicWavSize, const unsigned char* bonusWav, size_t bonusWavSize);
+
+// Queue an effect to start on the audio thread; safe from any thread
+void TriggerSoundEffect(AudioSystem& audio, SoundEffect effect);
+
+// Stop the thread and unload everything (before CloseAudioDevice)
+void StopAudio(AudioSystem& audio);
@@ -0,0 +1,150 @@
+#include "bat_swarm.h"
+#include "game.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BAT_SWARM_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define BAT_SWARM_AVX 1
+#include <immintrin.h>
+#endif
+
+void InitBatSwarm(BatSwarm& swarm, Vector2 frameSize, float scale, int framesSpeed) {
+    swarm.positionX.clear();
+    swarm.positionY.clear();
+    swarm.velocityX.clear();
+    swarm.velocityY.clear();
+    swarm.respawnTimer.clear();
+    swarm.frameCounter.clear();
+    swarm.currentFrame.clear();
+    swarm.frameSize = frameSize;
+    swarm.scale = scale;
+    swarm.width = frameSize.x * scale;
+    swarm.height = frameSize.y * scale;
+    swarm.framesSpeed = framesSpeed;
+    swarm.count = 0;
+}
+
+int AddBat(BatSwarm& swarm, Vector2 position, Vector2 velocity) {
+    swarm.positionX.push_back(position.x);
+    swarm.positionY.push_back(position.y);
+    swarm.velocityX.push_back(velocity.x);
+    swarm.velocityY.push_back(velocity.y);
+    swarm.respawnTimer.push_back(0);
+    swarm.frameCounter.push_back(0);
+    swarm.currentFrame.push_back(0);
+    return swarm.count++;
+}
+
+Rectangle GetBatBounds(const BatSwarm& swarm, int index) {
+    return {swarm.positionX[index], swarm.positionY[index], swarm.width, swarm.height};
+}
+
+// Respawn timers and fly-cycle animation
+static void UpdateBatTimers(BatSwarm& swarm) {
+    int32_t* respawn = swarm.respawnTimer.data();
+    int32_t* counter = swarm.frameCounter.data();
+    int32_t* frame = swarm.currentFrame.data();
+    int i = 0;
+#ifdef BAT_SWARM_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i speedMinusOne = _mm_set1_epi32(swarm.framesSpeed - 1);
+    const __m128i lastFrame = _mm_set1_epi32(batAnimationFrames - 1);
+    for (; i + 4 <= swarm.count; i += 4) {
+        // if (respawnTimer > 0) respawnTimer--
+        __m128i timer = _mm_loadu_si128(reinterpret_cast<__m128i*>(respawn + i));
+        timer = _mm_sub_epi32(timer, _mm_and_si128(_mm_cmpgt_epi32(timer, zero), one));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(respawn + i), timer);
+
+        // if (++frameCounter >= framesSpeed) { frameCounter = 0; advance frame, wrapping at 8 }
+        __m128i count = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(counter + i)), one);
+        __m128i advance = _mm_cmpgt_epi32(count, speedMinusOne);
+        count = _mm_andnot_si128(advance, count);
+        __m128i current = _mm_loadu_si128(reinterpret_cast<__m128i*>(frame + i));
+        __m128i next = _mm_add_epi32(current, one);
+        next = _mm_andnot_si128(_mm_cmpgt_epi32(next, lastFrame), next);
+        current = _mm_or_si128(_mm_and_si128(advance, next), _mm_andnot_si128(advance, current));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(counter + i), count);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), current);
+    }
+#endif
+    for (; i < swarm.count; i++) {
+        if (respawn[i] > 0) respawn[i]--;
+        counter[i]++;
+        if (counter[i] >= swarm.framesSpeed) {
+            counter[i] = 0;
+            frame[i]++;
+            if (frame[i] >= batAnimationFrames) frame[i] = 0;
+        }
+    }
+}
+
+// Move one axis and flip velocity where the bat touches an edge it is moving
+// towards (so a bat left outside a scrolling area heads back instead of
+// flipping every tick)
+static void MoveAndBounceAxis(float* position, float* velocity, int count, float size, float minEdge, float maxEdge) {
+    int i = 0;
+#ifdef BAT_SWARM_AVX
+    {
+        const __m256 lo = _mm256_set1_ps(minEdge);
+        const __m256 hi = _mm256_set1_ps(maxEdge);
+        const __m256 extent = _mm256_set1_ps(size);
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= count; i += 8) {
+            __m256 v = _mm256_loadu_ps(velocity + i);
+            __m256 p = _mm256_add_ps(_mm256_loadu_ps(position + i), v);
+            __m256 hit = _mm256_or_ps(
+                _mm256_and_ps(_mm256_cmp_ps(p, lo, _CMP_LE_OQ), _mm256_cmp_ps(v, zero, _CMP_LT_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(p, extent), hi, _CMP_GE_OQ),
+                              _mm256_cmp_ps(v, zero, _CMP_GT_OQ)));
+            _mm256_storeu_ps(position + i, p);
+            _mm256_storeu_ps(velocity + i, _mm256_xor_ps(v, _mm256_and_ps(hit, signBit)));
+        }
+    }
+#endif
+#ifdef BAT_SWARM_SSE2
+    {
+        const __m128 lo = _mm_set1_ps(minEdge);
+        const __m128 hi = _mm_set1_ps(maxEdge);
+        const __m128 extent = _mm_set1_ps(size);
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_loadu_ps(velocity + i);
+            __m128 p = _mm_add_ps(_mm_loadu_ps(position + i), v);
+            __m128 hit = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(p, lo), _mm_cmplt_ps(v, zero)),
+                                   _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(p, extent), hi), _mm_cmpgt_ps(v, zero)));
+            _mm_storeu_ps(position + i, p);
+            // velocity *= -1 is a sign flip, so the vector path stays bit-exact with the scalar one
+            _mm_storeu_ps(velocity + i, _mm_xor_ps(v, _mm_and_ps(hit, signBit)));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        position[i] += velocity[i];
+        if ((position[i] <= minEdge && velocity[i] < 0) || (position[i] + size >= maxEdge && velocity[i] > 0)) {
+            velocity[i] *= -1;
+        }
+    }
+}
+
+void UpdateBatSwarm(BatSwarm& swarm, Rectangle area) {
+    UpdateBatTimers(swarm);
+    MoveAndBounceAxis(swarm.positionX.data(), swarm.velocityX.data(), swarm.count,
+                      swarm.width, area.x, area.x + area.width);
+    MoveAndBounceAxis(swarm.positionY.data(), swarm.velocityY.data(), swarm.count,
+                      swarm.height, area.y, area.y + area.height);
+}
+
+const char* GetBatSwarmVectorPath() {
+#if defined(BAT_SWARM_AVX)
+    return "avx";
+#elif defined(BAT_SWARM_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
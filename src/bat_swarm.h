@@ -0,0 +1,41 @@
+#pragma once
+
+#include "raylib.h" // Vector2 / Rectangle
+#include <cstdint>
+#include <vector>
+
+// Structure-of-arrays store for every bat in the level. All bats share one
+// sprite size, so bounds are (positionX[i], positionY[i], width, height) and
+// the eight fly-cycle textures are owned once by the renderer, not per bat.
+struct BatSwarm {
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<int32_t> respawnTimer; // Ticks before the bat can hit the player again
+    std::vector<int32_t> frameCounter; // Counter for animation timing
+    std::vector<int32_t> currentFrame; // Current animation frame
+    Vector2 frameSize;   // Unscaled size of one animation frame
+    float scale;
+    float width;         // Scaled bounds shared by every bat
+    float height;
+    int framesSpeed;     // Speed of animation (ticks per frame)
+    int count;
+};
+
+// Reset the swarm to zero bats with the given sprite size
+void InitBatSwarm(BatSwarm& swarm, Vector2 frameSize, float scale, int framesSpeed = 5);
+
+// Append a bat and return its index
+int AddBat(BatSwarm& swarm, Vector2 position, Vector2 velocity);
+
+// Collision bounds of one bat
+Rectangle GetBatBounds(const BatSwarm& swarm, int index);
+
+// One tick for all bats: respawn timers, animation, movement and bouncing off
+// the edges of area (only edges a bat is moving towards, so area may scroll).
+// Vectorized with SSE2 (AVX for movement when built with FINDTREASURE_AVX).
+void UpdateBatSwarm(BatSwarm& swarm, Rectangle area);
+
+// Vector path UpdateBatSwarm was built with: "avx", "sse2" or "scalar"
+const char* GetBatSwarmVectorPath();
@@ -0,0 +1,179 @@
+#include "bot.h"
+#include "parallel.h"
+#include <algorithm>
+
+// Held buttons for a plan: first for firstTicks ticks, then rest
+struct BotPlan {
+    uint8_t first;
+    int firstTicks;
+    uint8_t rest;
+};
+
+// Jumps start at every replan-sized step of the horizon, so whatever the
+// distance to the next gap, some plan takes off in time to clear it
+static const BotPlan botPlans[] = {
+    {INPUT_RIGHT, 0, INPUT_RIGHT},                             // Run
+    {INPUT_RIGHT | INPUT_SPACE, 0, INPUT_RIGHT | INPUT_SPACE}, // Full running jump
+    {INPUT_RIGHT, 1, INPUT_RIGHT | INPUT_SPACE},               // Let go of jump, then jump again
+    {INPUT_RIGHT, 10, INPUT_RIGHT | INPUT_SPACE},              // Run, then jump
+    {INPUT_RIGHT, 20, INPUT_RIGHT | INPUT_SPACE},
+    {INPUT_RIGHT, 30, INPUT_RIGHT | INPUT_SPACE},
+    {INPUT_RIGHT, 40, INPUT_RIGHT | INPUT_SPACE},
+    {INPUT_RIGHT, 50, INPUT_RIGHT | INPUT_SPACE},
+    {INPUT_RIGHT, 60, INPUT_RIGHT | INPUT_SPACE},
+    {INPUT_RIGHT | INPUT_SPACE, 8, INPUT_RIGHT},               // Low jump
+    {INPUT_RIGHT | INPUT_SPACE, 10, INPUT_SPACE},              // Short hop onto a narrow step
+    {INPUT_SPACE, 12, INPUT_RIGHT | INPUT_SPACE},              // Straight up, then right (up a wall)
+    {0, 15, INPUT_RIGHT},                                      // Wait for a bat to pass
+    {0, 40, INPUT_RIGHT},
+    {INPUT_LEFT, 12, INPUT_RIGHT | INPUT_SPACE},               // Back up, then jump
+    {INPUT_LEFT | INPUT_SPACE, 20, INPUT_RIGHT},               // Jump back over a bat
+};
+const int botPlanCount = sizeof(botPlans) / sizeof(botPlans[0]);
+
+// Reaching the flag in a rollout ranks above any progress
+const float flagScore = 1e6f;
+
+// Longest a rollout runs while waiting for the player to land
+const int maxRolloutTicks = ticksPerSecond * 3;
+
+BotSettings DefaultBotSettings() {
+    BotSettings settings;
+    settings.horizonTicks = 80;
+    settings.replanTicks = 10;
+    settings.batHitPenalty = 600.0f;
+    settings.fallPenalty = 400.0f;
+    return settings;
+}
+
+void InitBot(Bot& bot, const BotSettings& settings) {
+    bot.settings = settings;
+    bot.plan = 0;
+    bot.planTick = 0;
+    bot.sinceReplan = 0;
+}
+
+static uint8_t PlanButtons(const BotPlan& plan, int tick) {
+    return tick < plan.firstTicks ? plan.first : plan.rest;
+}
+
+// Play plan from its startTick'th tick on a copy of state and score the outcome
+static float ScorePlan(Bot& bot, const GameState& state, const BotPlan& plan, int startTick) {
+    GameState& sim = bot.scratch;
+    sim = state;
+    int hits = sim.score.bat;
+    // Past the horizon, keep going until the player is back on something, or a
+    // plan could look good just by putting its fall off until after the horizon
+    for (int t = 0; t < bot.settings.horizonTicks || (sim.player.isJumping && t < maxRolloutTicks); t++) {
+        Step(sim, {PlanButtons(plan, startTick + t)});
+        if (sim.levelComplete) return flagScore - t;
+        // Every platform top is above the bottom of the screen, so this is a fall into a gap. The
+        // game puts the player back where they last stood, which may be past earlier gaps, so a
+        // plan that clears one gap and then falls still beats one that never leaves.
+        if (sim.player.position.y + sim.player.bounds.height > screenHeight) {
+            return sim.player.lastSafePosition.x - bot.settings.fallPenalty -
+                   (sim.score.bat - hits) * bot.settings.batHitPenalty;
+        }
+    }
+    return sim.player.position.x - (sim.score.bat - hits) * bot.settings.batHitPenalty;
+}
+
+InputFrame GetBotInput(Bot& bot, const GameState& state) {
+    if (state.levelComplete) return {0};
+
+    // A new level (InitGame resets the tick) or time to look again
+    if (state.tick == 0 || bot.sinceReplan >= bot.settings.replanTicks) {
+        // Ties go to the earlier plan in the table (running before waiting).
+        // Carrying on with the current plan competes too, so the bot finishes
+        // what it started (backing up for a run-up) when that is strictly better.
+        int best = 0, bestTick = 0;
+        float bestScore = -flagScore;
+        for (int i = 0; i < botPlanCount; i++) {
+            float score = ScorePlan(bot, state, botPlans[i], 0);
+            if (score > bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        if (state.tick > 0 && bot.planTick > 0 &&
+            ScorePlan(bot, state, botPlans[bot.plan], bot.planTick) > bestScore) {
+            best = bot.plan;
+            bestTick = bot.planTick;
+        }
+        bot.plan = best;
+        bot.planTick = bestTick;
+        bot.sinceReplan = 0;
+    }
+
+    InputFrame input = {PlanButtons(botPlans[bot.plan], bot.planTick)};
+    bot.planTick++;
+    bot.sinceReplan++;
+    return input;
+}
+
+InputProvider MakeBotInputProvider(Bot& bot) {
+    return [&bot](const GameState& state) { return GetBotInput(bot, state); };
+}
+
+void PlayHeadlessGame(GameState& state, const InputProvider& provider, int maxTicks, BotGameResult& result) {
+    result.seed = state.world.seed;
+    result.reachedFlag = false;
+    result.ticks = maxTicks;
+    for (int t = 0; t < maxTicks; t++) {
+        Step(state, provider(state));
+        if (state.levelComplete) {
+            result.reachedFlag = true;
+            result.ticks = t + 1;
+            break;
+        }
+    }
+    result.batHits = state.score.bat;
+}
+
+BotRunSettings DefaultBotRunSettings() {
+    BotRunSettings settings;
+    settings.firstSeed = 1;
+    settings.games = 1000;
+    settings.levelChunks = defaultLevelChunks;
+    settings.maxTicks = ticksPerSecond * 120;
+    settings.threadCount = 0;
+    settings.playerSpriteSize = defaultPlayerSpriteSize;
+    settings.batFrameSize = defaultBatFrameSize;
+    settings.bot = DefaultBotSettings();
+    return settings;
+}
+
+void RunBotGames(const BotRunSettings& settings, std::vector<BotGameResult>& results) {
+    results.resize(std::max(0, settings.games));
+    ParallelFor(settings.games, settings.threadCount, [&](int i) {
+        static thread_local GameState state;
+        static thread_local Bot bot;
+        InitGame(state, static_cast<unsigned int>(settings.firstSeed + i), settings.playerSpriteSize,
+                 settings.batFrameSize, settings.levelChunks);
+        InitBot(bot, settings.bot);
+        PlayHeadlessGame(state, MakeBotInputProvider(bot), settings.maxTicks, results[i]);
+    });
+}
+
+void SummarizeBotGames(const std::vector<BotGameResult>& results, BotRunSummary& summary) {
+    summary = {};
+    summary.games = static_cast<int>(results.size());
+    std::vector<float> seconds;
+    int hits = 0;
+    for (const BotGameResult& result : results) {
+        hits += result.batHits;
+        if (!result.reachedFlag) continue;
+        summary.wins++;
+        seconds.push_back(static_cast<float>(result.ticks) / ticksPerSecond);
+    }
+    if (summary.games == 0) return;
+    summary.winRate = static_cast<float>(summary.wins) / summary.games;
+    summary.meanBatHits = static_cast<float>(hits) / summary.games;
+    if (seconds.empty()) return;
+    std::sort(seconds.begin(), seconds.end());
+    float total = 0;
+    for (float s : seconds) total += s;
+    summary.meanSecondsToFlag = total / seconds.size();
+    summary.p50SecondsToFlag = seconds[seconds.size() / 2];
+    summary.p90SecondsToFlag = seconds[std::min(seconds.size() - 1, seconds.size() * 9 / 10)];
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "game.h"
+#include <functional>
+#include <vector>
+
+// Where a tick's buttons come from: called once per tick, before Step, with
+// the state that tick will advance. The keyboard, a recording and the bot
+// below all fit, so the game and headless runners can take any of them.
+using InputProvider = std::function<InputFrame(const GameState& state)>;
+
+// Knobs for the bot; DefaultBotSettings gives a bot that reaches the flag on
+// practically every generated level
+struct BotSettings {
+    int horizonTicks;     // How far ahead each candidate plan is simulated
+    int replanTicks;      // Ticks a chosen plan runs before the next search
+    float batHitPenalty;  // Progress (pixels) the bot gives up to avoid one bat hit
+    float fallPenalty;    // Same, to avoid falling into a gap
+};
+
+BotSettings DefaultBotSettings();
+
+// Search-based player. Every replanTicks it plays a fixed set of button plans
+// (run, jump, short hop, wait, back up and jump...) forward with Step on a
+// copy of the state and keeps the one that gets furthest right, counting a fall
+// into a gap as ending where the game respawns the player and reaching the
+// flag soonest if any plan does. The simulation is
+// deterministic, so the copy sees exactly the bats and platforms the game will.
+struct Bot {
+    BotSettings settings;
+    GameState scratch;  // Rollout copy, reused so searching does not allocate
+    int plan;           // Index into the plan table of the plan being played
+    int planTick;       // Ticks played of it
+    int sinceReplan;
+};
+
+void InitBot(Bot& bot, const BotSettings& settings);
+
+// Buttons for the tick that will advance state
+InputFrame GetBotInput(Bot& bot, const GameState& state);
+
+// An InputProvider that asks bot (which must outlive it)
+InputProvider MakeBotInputProvider(Bot& bot);
+
+// One headless game played by an InputProvider
+struct BotGameResult {
+    uint64_t seed;
+    bool reachedFlag;
+    int ticks;     // Ticks until the flag was reached, or maxTicks
+    int batHits;
+};
+
+// Step state with input from provider until the flag is reached or maxTicks pass
+void PlayHeadlessGame(GameState& state, const InputProvider& provider, int maxTicks, BotGameResult& result);
+
+struct BotRunSettings {
+    uint64_t firstSeed;  // Game i plays the level for seed firstSeed + i
+    int games;
+    int levelChunks;
+    int maxTicks;        // A game that has not reached the flag by then counts as lost
+    int threadCount;     // 0 = all cores
+    Vector2 playerSpriteSize;
+    Vector2 batFrameSize;
+    BotSettings bot;
+};
+
+BotRunSettings DefaultBotRunSettings();
+
+// Play settings.games independent games with the bot across a thread pool
+// (one bot and game state per thread); results[i] is game i
+void RunBotGames(const BotRunSettings& settings, std::vector<BotGameResult>& results);
+
+// Aggregate of RunBotGames' results
+struct BotRunSummary {
+    int games;
+    int wins;
+    float winRate;
+    float meanSecondsToFlag;  // Over won games
+    float p50SecondsToFlag;
+    float p90SecondsToFlag;
+    float meanBatHits;        // Over all games
+};
+
+void SummarizeBotGames(const std::vector<BotGameResult>& results, BotRunSummary& summary);
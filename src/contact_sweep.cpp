@@ -0,0 +1,80 @@
+#include "contact_sweep.h"
+#include <algorithm>
+
+void InitContactSweep(ContactSweep& sweep, bool findEnemyPairs) {
+    sweep.enemies.clear();
+    sweep.players.clear();
+    sweep.findEnemyPairs = findEnemyPairs;
+    sweep.boxes.clear();
+    sweep.order.clear();
+    sweep.playerContacts.clear();
+    sweep.enemyContacts.clear();
+    sweep.sortMoves = 0;
+}
+
+static SweepBox MakeSweepBox(Rectangle bounds) {
+    return {bounds.x, bounds.x + bounds.width, bounds.y, bounds.y + bounds.height};
+}
+
+static bool ContactLess(const SweepContact& a, const SweepContact& b) {
+    return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+void UpdateContactSweep(ContactSweep& sweep) {
+    const int enemyCount = static_cast<int>(sweep.enemies.size());
+    const int bodyCount = enemyCount + static_cast<int>(sweep.players.size());
+    sweep.boxes.resize(bodyCount);
+    for (int i = 0; i < enemyCount; i++) {
+        sweep.boxes[i] = MakeSweepBox(sweep.enemies[i]);
+    }
+    for (int i = enemyCount; i < bodyCount; i++) {
+        sweep.boxes[i] = MakeSweepBox(sweep.players[i - enemyCount]);
+    }
+
+    // Bodies added or removed: indices no longer mean the same thing, start over
+    if (static_cast<int>(sweep.order.size()) != bodyCount) {
+        sweep.order.resize(bodyCount);
+        for (int i = 0; i < bodyCount; i++) sweep.order[i] = i;
+    }
+
+    // Insertion sort by left edge; between ticks only bodies that crossed each other move
+    const SweepBox* boxes = sweep.boxes.data();
+    int* order = sweep.order.data();
+    sweep.sortMoves = 0;
+    for (int i = 1; i < bodyCount; i++) {
+        int body = order[i];
+        float minX = boxes[body].minX;
+        int j = i;
+        while (j > 0 && boxes[order[j - 1]].minX > minX) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = body;
+        sweep.sortMoves += i - j;
+    }
+
+    // Sweep: each body only meets the ones that start before it ends
+    sweep.playerContacts.clear();
+    sweep.enemyContacts.clear();
+    for (int i = 0; i < bodyCount; i++) {
+        int a = order[i];
+        const SweepBox& boxA = boxes[a];
+        for (int j = i + 1; j < bodyCount; j++) {
+            int b = order[j];
+            const SweepBox& boxB = boxes[b];
+            if (boxB.minX >= boxA.maxX) break;
+            bool enemyA = a < enemyCount, enemyB = b < enemyCount;
+            if (!enemyA && !enemyB) continue;
+            if (enemyA && enemyB && !sweep.findEnemyPairs) continue;
+            if (!(boxA.minX < boxB.maxX && boxA.maxX > boxB.minX && boxA.minY < boxB.maxY && boxA.maxY > boxB.minY)) {
+                continue;
+            }
+            if (enemyA && enemyB) {
+                sweep.enemyContacts.push_back({std::min(a, b), std::max(a, b)});
+            } else {
+                sweep.playerContacts.push_back({enemyA ? a : b, (enemyA ? b : a) - enemyCount});
+            }
+        }
+    }
+    std::sort(sweep.playerContacts.begin(), sweep.playerContacts.end(), ContactLess);
+}
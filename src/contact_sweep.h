@@ -0,0 +1,45 @@
+#pragma once
+
+#include "raylib.h" // Rectangle
+#include <cstdint>
+#include <vector>
+
+// Overlapping pair found by UpdateContactSweep: an enemy and a player, or two
+// enemies (first < second)
+struct SweepContact {
+    int first;
+    int second;
+};
+
+// Box used by the sweep, one per body; bodies are the enemies followed by the players
+struct SweepBox {
+    float minX, maxX;
+    float minY, maxY;
+};
+
+// Sort-and-sweep broadphase for N enemies against M players. Bodies stay
+// sorted by left edge from one tick to the next, so re-sorting after they move
+// is an insertion sort over a nearly sorted list: close to linear, instead of
+// the N*M tests of checking every pair. Callers fill the bounds each tick; the
+// vectors keep their capacity, so a steady tick does not allocate.
+struct ContactSweep {
+    std::vector<Rectangle> enemies; // Bounds, filled by the caller before each update
+    std::vector<Rectangle> players;
+    bool findEnemyPairs;            // Also report overlapping enemies (for separation)
+
+    std::vector<SweepBox> boxes;    // Per body, rebuilt from the bounds each update
+    std::vector<int> order;         // Body indices by left edge, kept between updates
+    std::vector<SweepContact> playerContacts; // Enemy index, player index; by enemy, then player
+    std::vector<SweepContact> enemyContacts;  // Enemy pairs, in sweep order
+    int sortMoves;                  // Insertion-sort shifts in the last update (0 when nothing crossed)
+};
+
+// Empty the sweep; enemy pairs are only reported when findEnemyPairs is set
+void InitContactSweep(ContactSweep& sweep, bool findEnemyPairs);
+
+// Re-sort the bodies and list every overlapping enemy-player pair (and enemy
+// pair, if enabled), with the same strict test as CheckCollisionRecs. Player
+// contacts come out sorted, so handling them in order does not depend on
+// earlier ticks; enemy pairs (many more in a crowd) are left in sweep order.
+// When the number of bodies changes the order is rebuilt from scratch.
+void UpdateContactSweep(ContactSweep& sweep);
@@ -0,0 +1,46 @@
+#include "fixed_timestep.h"
+#include <cmath>
+
+// Farther than any object moves in one tick, so a bigger jump is a respawn
+static const float maxInterpolationDistance = static_cast<float>(tileSize);
+
+void InitFixedTimestep(FixedTimestep& timestep, int ticksPerSecond, int maxTicksPerFrame) {
+    timestep.tickSeconds = 1.0 / ticksPerSecond;
+    timestep.accumulator = 0;
+    timestep.maxTicksPerFrame = maxTicksPerFrame;
+}
+
+int AdvanceFixedTimestep(FixedTimestep& timestep, double frameSeconds) {
+    if (frameSeconds > 0) timestep.accumulator += frameSeconds;
+    // The epsilon keeps rounding in the accumulated sum from deferring a due tick
+    int ticks = static_cast<int>(timestep.accumulator / timestep.tickSeconds + 1e-6);
+    if (ticks > timestep.maxTicksPerFrame) {
+        // Too far behind (debugger, window drag, slow frame): run the cap and
+        // drop the rest, so the game slows down instead of freezing
+        ticks = timestep.maxTicksPerFrame;
+        timestep.accumulator = ticks * timestep.tickSeconds;
+    }
+    timestep.accumulator -= ticks * timestep.tickSeconds;
+    if (timestep.accumulator < 0) timestep.accumulator = 0;
+    return ticks;
+}
+
+float GetInterpolationAlpha(const FixedTimestep& timestep) {
+    float alpha = static_cast<float>(timestep.accumulator / timestep.tickSeconds);
+    return alpha < 0 ? 0 : (alpha >= 1 ? 1 : alpha);
+}
+
+void CapturePositions(const GameState& state, InterpolationFrame& frame) {
+    frame.cameraX = state.cameraX;
+    frame.player = state.player.position;
+    frame.batX.assign(state.bats.positionX.begin(), state.bats.positionX.begin() + state.bats.count);
+    frame.batY.assign(state.bats.positionY.begin(), state.bats.positionY.begin() + state.bats.count);
+}
+
+Vector2 InterpolatePosition(Vector2 previous, Vector2 current, float alpha) {
+    if (fabsf(current.x - previous.x) > maxInterpolationDistance ||
+        fabsf(current.y - previous.y) > maxInterpolationDistance) {
+        return current;
+    }
+    return {previous.x + (current.x - previous.x) * alpha, previous.y + (current.y - previous.y) * alpha};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "game.h"
+#include <vector>
+
+// Accumulator that turns variable frame times into a whole number of fixed
+// simulation ticks. All gameplay constants are per tick, so running Step at a
+// fixed rate keeps physics identical at any display refresh rate.
+struct FixedTimestep {
+    double tickSeconds;   // Length of one simulation tick
+    double accumulator;   // Unsimulated time carried into the next frame
+    int maxTicksPerFrame; // Catch-up cap; time beyond it is dropped so a stall cannot spiral
+};
+
+void InitFixedTimestep(FixedTimestep& timestep, int ticksPerSecond, int maxTicksPerFrame);
+
+// Add one frame's elapsed time and return how many ticks to run now
+int AdvanceFixedTimestep(FixedTimestep& timestep, double frameSeconds);
+
+// How far the render time is between the last two ticks, in [0, 1)
+float GetInterpolationAlpha(const FixedTimestep& timestep);
+
+// Positions of everything that moves, captured before a tick so the renderer can
+// draw between the previous and the current tick
+struct InterpolationFrame {
+    float cameraX;
+    Vector2 player;
+    std::vector<float> batX;
+    std::vector<float> batY;
+};
+
+void CapturePositions(const GameState& state, InterpolationFrame& frame);
+
+// Blend from previous to current; teleports (respawns) snap instead of sliding
+Vector2 InterpolatePosition(Vector2 previous, Vector2 current, float alpha);
@@ -0,0 +1,519 @@
+#include "game.h"
+#include "level_generator.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath> // For fabsf in the collision sweep
+
+// Same test as raylib's CheckCollisionRecs, kept here so the simulation links without raylib
+static bool RectsOverlap(Rectangle a, Rectangle b) {
+    return a.x < b.x + b.width && a.x + a.width > b.x &&
+           a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+void SeedRng(Rng& rng, uint64_t seed) {
+    // splitmix64 scramble so nearby seeds give unrelated sequences and the state is never zero
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    rng.state = z ? z : 0x9E3779B97F4A7C15ull;
+}
+
+static uint32_t NextRandom(Rng& rng) {
+    rng.state ^= rng.state >> 12;
+    rng.state ^= rng.state << 25;
+    rng.state ^= rng.state >> 27;
+    return static_cast<uint32_t>((rng.state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+int RandomInt(Rng& rng, int min, int max) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    uint32_t range = static_cast<uint32_t>(max - min) + 1u;
+    return min + static_cast<int>(NextRandom(rng) % range);
+}
+
+// Function to respawn a bat at a random position away from the players
+void RespawnBat(BatSwarm& bats, int index, const Vector2* players, int playerCount, Rng& rng, Rectangle area,
+                SpawnSampler& spawns) {
+    // Anywhere in the top third of the screen at least 5 bat lengths from every player
+    float minDistance = bats.width * 5;
+    Rectangle band = {area.x, area.y, area.width - bats.width, area.height / 3};
+    UpdateSpawnSampler(spawns, band, players, playerCount, minDistance);
+
+    Vector2 newPos;
+    if (!SampleSpawnPoint(spawns, rng, newPos)) {
+        // Nowhere is far enough: place the bat at the opposite side of the screen from the first player
+        newPos.x = area.x + ((playerCount > 0 && players[0].x < area.x + area.width / 2) ?
+                             (area.width - bats.width - 10) : 10);
+        newPos.y = area.y + 50;
+    }
+
+    // Set the new position
+    bats.positionX[index] = newPos.x;
+    bats.positionY[index] = newPos.y;
+
+    // Reset velocity (optional: give it a random direction)
+    // Make sure the bat has a non-zero velocity
+    float velocityX = (RandomInt(rng, 0, 1) == 0 ? -1.0f : 1.0f) * batSpeed;
+    float velocityY = static_cast<float>(RandomInt(rng, 0, 1)) * batSpeed;
+
+    // If both velocities are zero, give it a default movement
+    if (velocityX == 0 && velocityY == 0) {
+        velocityX = batSpeed;
+    }
+    bats.velocityX[index] = velocityX;
+    bats.velocityY[index] = velocityY;
+}
+
+// Keep the player centered while staying inside the level
+static float CameraTarget(const GameState& state) {
+    float target = state.player.position.x + state.player.bounds.width / 2 - screenWidth / 2;
+    return std::max(0.0f, std::min(target, state.world.width - screenWidth));
+}
+
+void StreamLevel(GameState& state) {
+    if (StreamWorld(state.world, state.cameraX, static_cast<float>(screenWidth))) {
+        CollectWorldPlatforms(state.world, state.platforms);
+        BuildPlatformGrid(state.platformGrid, state.platforms);
+    }
+}
+
+void InitGame(GameState& state, unsigned int seed, Vector2 playerSpriteSize, Vector2 batFrameSize,
+              int levelChunks) {
+    // One validator per thread, so games can be set up in parallel without reallocating
+    static thread_local LevelValidator validator;
+    static thread_local Level level;
+    static thread_local BakedLevel baked;
+    LevelSettings settings = DefaultLevelSettings(levelChunks);
+    settings.playerSize = {playerSpriteSize.x * batScale, playerSpriteSize.y * batScale};
+    GenerateLevel(level, seed, settings, validator);
+    BakeLevel(level, baked);
+    InitGame(state, baked.view, playerSpriteSize, batFrameSize);
+}
+
+void InitGame(GameState& state, const LevelView& level, Vector2 playerSpriteSize, Vector2 batFrameSize) {
+    SeedRng(state.rng, level.seed);
+
+    // Initialize player standing on the level's spawn point
+    float playerWidth = playerSpriteSize.x * batScale;
+    float playerHeight = playerSpriteSize.y * batScale;
+    Vector2 spawn = {level.playerSpawn.x, level.playerSpawn.y - playerHeight};
+    state.player = {
+        spawn,                      // position adjusted to be on top of the floor
+        {0, 0},                     // velocity
+        playerSpeed,                // speed
+        false,                      // isJumping
+        {spawn.x, spawn.y, playerWidth, playerHeight},  // bounds updated to match bat scale
+        true,                       // isFacingRight
+        0,                          // invulnerabilityTimer
+        0,                          // coyoteTimer
+        0,                          // jumpBufferTimer
+        0,                          // jumpHoldTimer
+        false,                      // isJumpHeld
+        spawn                       // lastSafePosition
+    };
+
+    // Initialize bat enemy; more join from the level's bat zones as the camera reaches them
+    InitBatSwarm(state.bats, batFrameSize, batScale, 5); // framesSpeed (adjust for desired animation speed)
+    AddBat(state.bats,
+           {static_cast<float>(screenWidth / 2), 100.0f},  // position
+           {batSpeed, batSpeed * 0.5f});                 // velocity - ensure it has vertical movement
+    state.nextBatZone = 0;
+    InitContactSweep(state.batContacts, false);
+    InitSpawnSampler(state.batSpawns);
+
+    // Initialize score
+    state.score = {0, 0};
+
+    // Stream the level: only the chunks around the camera are resident
+    InitWorld(state.world, level);
+    state.cameraX = 0;
+    state.platforms.clear();
+    StreamLevel(state);
+
+    // Initialize flag at the top of the stairs at the end of the level
+    Vector2 flagPosition = state.world.flagPosition;
+    state.flag = {
+        flagPosition,
+        {flagPosition.x, flagPosition.y, flagSize.x, flagSize.y},
+        false, // not reached yet
+        0.0f   // wave timer
+    };
+
+    state.levelComplete = false;
+    state.transitionTimer = 0;
+    state.previousButtons = 0;
+    state.tick = 0;
+}
+
+// Horizontal input, jump buffer/coyote timers, variable jump and gravity
+static void UpdatePlayerMovement(Player& player, InputFrame input, uint8_t pressed) {
+    // Handle player movement
+    float moveSpeed = player.speed;
+    if (player.isJumping) {
+        // Reduce control in the air
+        moveSpeed *= airControlFactor;
+    }
+
+    // Horizontal speed for this tick; the position is moved by the collision sweep
+    player.velocity.x = 0;
+    if (input.buttons & INPUT_RIGHT) {
+        player.velocity.x += moveSpeed;
+        player.isFacingRight = true;
+    }
+    if (input.buttons & INPUT_LEFT) {
+        player.velocity.x -= moveSpeed;
+        player.isFacingRight = false;
+    }
+
+    // Handle jump buffer (remember jump input for a few frames)
+    if (pressed & (INPUT_SPACE | INPUT_UP)) {
+        player.jumpBufferTimer = jumpBufferFrames;
+    }
+
+    // Track if jump button is held down
+    player.isJumpHeld = (input.buttons & (INPUT_SPACE | INPUT_UP)) != 0;
+
+    // Handle jumping with coyote time and jump buffer
+    if ((player.jumpBufferTimer > 0) && (player.coyoteTimer > 0 || !player.isJumping)) {
+        player.velocity.y = jumpForce;
+        player.isJumping = true;
+        player.jumpHoldTimer = maxJumpHoldTime;
+        player.jumpBufferTimer = 0;
+        player.coyoteTimer = 0;
+    }
+
+    // Variable jump height based on how long jump is held
+    if (player.isJumpHeld && player.jumpHoldTimer > 0 && player.velocity.y < 0) {
+        player.velocity.y += jumpHoldForce;
+        player.jumpHoldTimer--;
+    } else {
+        player.jumpHoldTimer = 0;
+    }
+
+    // Apply gravity with terminal velocity
+    player.velocity.y += gravity;
+    if (player.velocity.y > terminalVelocity) {
+        player.velocity.y = terminalVelocity;
+    }
+
+    // Decrement timers
+    if (player.jumpBufferTimer > 0) player.jumpBufferTimer--;
+    if (player.coyoteTimer > 0) player.coyoteTimer--;
+}
+
+// How far the interval [start, start + size) may move by delta before it enters
+// [wallStart, wallEnd). Walls it already overlaps are ignored so a player
+// spawned inside a platform can still get out.
+static float SweepInterval(float start, float size, float delta, float wallStart, float wallEnd) {
+    if (delta > 0) {
+        float leading = start + size;
+        if (leading <= wallStart + collisionSkin && leading + delta > wallStart) return wallStart - leading;
+    } else if (delta < 0) {
+        if (start >= wallEnd - collisionSkin && start + delta < wallEnd) return wallEnd - start;
+    }
+    return delta;
+}
+
+// Move the player by delta along one axis, stopping at the first platform in
+// the way (time of impact against every platform the swept box touches), so
+// no speed or tick length can tunnel through a tile. Returns true if blocked.
+static bool SweepPlayerAxis(GameState& state, bool horizontal, float delta) {
+    Player& player = state.player;
+    if (delta == 0) return false;
+
+    Rectangle box = {player.position.x, player.position.y, player.bounds.width, player.bounds.height};
+    Rectangle swept = box;
+    if (horizontal) {
+        swept.x = std::min(box.x, box.x + delta);
+        swept.width += fabsf(delta);
+    } else {
+        swept.y = std::min(box.y, box.y + delta);
+        swept.height += fabsf(delta);
+    }
+    QueryPlatformGrid(state.platformGrid, swept, state.collisionCandidates);
+
+    float allowed = delta;
+    for (int index : state.collisionCandidates) {
+        const Rectangle& rect = state.platforms[index].rect;
+        float limit;
+        if (horizontal) {
+            // Only platforms in the player's row; resting on a tile is not a side hit
+            if (box.y + box.height <= rect.y + collisionSkin || box.y >= rect.y + rect.height - collisionSkin) continue;
+            limit = SweepInterval(box.x, box.width, delta, rect.x, rect.x + rect.width);
+        } else {
+            if (box.x + box.width <= rect.x + collisionSkin || box.x >= rect.x + rect.width - collisionSkin) continue;
+            limit = SweepInterval(box.y, box.height, delta, rect.y, rect.y + rect.height);
+        }
+        // Nearest wall wins
+        if (delta > 0 ? limit < allowed : limit > allowed) allowed = limit;
+    }
+
+    if (horizontal) {
+        player.position.x += allowed;
+    } else {
+        player.position.y += allowed;
+    }
+    return allowed != delta;
+}
+
+// Move the player through the platforms: x first, then y from the new x, each
+// axis stopping at its time of impact
+static void MovePlayer(GameState& state) {
+    Player& player = state.player;
+
+    if (SweepPlayerAxis(state, true, player.velocity.x)) {
+        player.velocity.x = 0;
+    }
+
+    bool onGround = false;
+    if (SweepPlayerAxis(state, false, player.velocity.y)) {
+        if (player.velocity.y > 0) {
+            // Landed on top of a platform
+            onGround = true;
+        } else {
+            // Hit a platform from below
+            player.jumpHoldTimer = 0; // Stop variable jump when hitting ceiling
+        }
+        player.velocity.y = 0;
+    }
+
+    // Update jumping state and coyote time
+    if (onGround) {
+        player.isJumping = false;
+        player.coyoteTimer = coyoteTimeFrames;
+    } else if (!player.isJumping) {
+        // Start coyote time when player leaves a platform without jumping
+        player.isJumping = true;
+        if (player.coyoteTimer <= 0) {
+            player.coyoteTimer = coyoteTimeFrames;
+        }
+    }
+
+    // The level's ends are walls
+    player.position.x = std::max(0.0f, std::min(player.position.x, state.world.width - player.bounds.width));
+    if (onGround) {
+        // Only remember spots where the whole player is on one platform, not the lip of a gap.
+        // collisionCandidates still holds the vertical sweep's platforms.
+        float feet = player.position.y + player.bounds.height;
+        for (int index : state.collisionCandidates) {
+            const Rectangle& rect = state.platforms[index].rect;
+            if (fabsf(rect.y - feet) <= collisionSkin && rect.x <= player.position.x &&
+                player.position.x + player.bounds.width <= rect.x + rect.width) {
+                player.lastSafePosition = player.position;
+                break;
+            }
+        }
+    }
+
+    // Check if player has fallen into a gap
+    if (player.position.y > screenHeight + player.bounds.height * 2) {
+        // Respawn player where they last stood
+        player.position = player.lastSafePosition;
+        player.velocity.x = 0;
+        player.velocity.y = 0;
+    }
+
+    // Update player bounds
+    player.bounds.x = player.position.x;
+    player.bounds.y = player.position.y;
+}
+
+// Bat animation, movement, screen-edge bounce and player hits
+static void UpdateBats(GameState& state) {
+    BatSwarm& bats = state.bats;
+    Player& player = state.player;
+
+    // Bats live in the view: they bounce off its edges and get pushed along when it scrolls
+    Rectangle arena = {state.cameraX, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)};
+
+    // Release a bat from each zone the view has reached, anywhere in the visible part of the zone
+    const std::vector<Rectangle>& zones = state.world.batZones;
+    while (state.nextBatZone < static_cast<int>(zones.size()) &&
+           zones[state.nextBatZone].x < arena.x + arena.width) {
+        const Rectangle& zone = zones[state.nextBatZone++];
+        if (bats.count >= maxBats) continue;
+        float left = std::max(zone.x, arena.x);
+        float right = std::min(zone.x + zone.width, arena.x + arena.width) - bats.width;
+        int spreadX = static_cast<int>(std::max(0.0f, right - left));
+        int spreadY = static_cast<int>(std::max(0.0f, zone.height - bats.height));
+        Vector2 position = {left + RandomInt(state.rng, 0, spreadX), zone.y + RandomInt(state.rng, 0, spreadY)};
+        Vector2 velocity = {RandomInt(state.rng, 0, 1) ? batSpeed : -batSpeed, batSpeed * 0.5f};
+        AddBat(bats, position, velocity);
+    }
+
+    UpdateBatSwarm(bats, arena);
+
+    // Keep bats inside the view and find the ones touching the player
+    ContactSweep& sweep = state.batContacts;
+    sweep.enemies.resize(bats.count);
+    for (int i = 0; i < bats.count; i++) {
+        bats.positionX[i] = std::max(arena.x, std::min(bats.positionX[i], arena.x + arena.width - bats.width));
+        sweep.enemies[i] = GetBatBounds(bats, i);
+    }
+    sweep.players.assign(1, player.bounds);
+    UpdateContactSweep(sweep);
+
+    // Contacts come in bat order (there is one player), so the first bat that can hit scores
+    for (const SweepContact& contact : sweep.playerContacts) {
+        int i = contact.first;
+
+        // A hit counts only if player is not invulnerable and bat can respawn
+        if (player.invulnerabilityTimer <= 0 && bats.respawnTimer[i] <= 0) {
+            // Increment bat score
+            state.score.bat++;
+
+            // Make player invulnerable for a short time
+            player.invulnerabilityTimer = invulnerabilityFrames;
+
+            // Respawn bat in a random position away from player
+            RespawnBat(bats, i, &player.position, 1, state.rng, arena, state.batSpawns);
+
+            // Set bat respawn timer to prevent immediate respawn
+            bats.respawnTimer[i] = batRespawnFrames;
+        }
+    }
+}
+
+static void MoveAndCollidePlayer(GameState& state, InputFrame input, uint8_t pressed) {
+    {
+        PROFILE_SCOPE(PROFILE_PHYSICS);
+        UpdatePlayerMovement(state.player, input, pressed);
+    }
+    {
+        PROFILE_SCOPE(PROFILE_COLLISION);
+        MovePlayer(state);
+    }
+}
+
+void Step(GameState& state, InputFrame input) {
+    uint8_t pressed = input.buttons & ~state.previousButtons;
+    state.previousButtons = input.buttons;
+
+    if (state.levelComplete) {
+        if (state.transitionTimer > 0) state.transitionTimer--;
+    } else {
+        Player& player = state.player;
+        MoveAndCollidePlayer(state, input, pressed);
+
+        // Scroll the view with the player and stream chunks in/out around it
+        state.cameraX = CameraTarget(state);
+        StreamLevel(state);
+
+        // Update invulnerability timer
+        if (player.invulnerabilityTimer > 0) {
+            player.invulnerabilityTimer--;
+        }
+
+        {
+            PROFILE_SCOPE(PROFILE_BATS);
+            UpdateBats(state);
+        }
+
+        // Update flag wave animation
+        state.flag.waveTimer += 0.05f;
+    }
+
+    // Check if player reached the flag
+    if (!state.flag.reached && RectsOverlap(state.player.bounds, state.flag.bounds)) {
+        state.flag.reached = true;
+        state.score.player++; // Increment player score when flag is reached
+
+        // Make the flag wave faster when reached
+        state.flag.waveTimer = 0.0f;
+
+        // Freeze play until the next level is swapped in
+        state.levelComplete = true;
+        state.transitionTimer = levelTransitionTicks;
+    }
+
+    state.tick++;
+}
+
+bool LevelTransitionDue(const GameState& state) {
+    return state.levelComplete && state.transitionTimer == 0;
+}
+
+void StepPlayer(GameState& state, InputFrame input) {
+    uint8_t pressed = input.buttons & ~state.previousButtons;
+    state.previousButtons = input.buttons;
+    MoveAndCollidePlayer(state, input, pressed);
+}
+
+void TraceJumpArc(uint8_t buttons, int ticks, std::vector<Vector2>& arc, int coyoteTicks) {
+    Player player = {};
+    player.speed = playerSpeed;
+    player.coyoteTimer = coyoteTimeFrames;
+    uint8_t previous = 0;
+    arc.clear();
+    for (int t = 0; t < ticks; t++) {
+        uint8_t held = t < coyoteTicks ? static_cast<uint8_t>(buttons & ~(INPUT_SPACE | INPUT_UP)) : buttons;
+        UpdatePlayerMovement(player, {held}, held & ~previous);
+        previous = held;
+        player.position.x += player.velocity.x;
+        player.position.y += player.velocity.y;
+        if (t < coyoteTicks) player.isJumping = true; // Off the edge, as MovePlayer would find
+        arc.push_back(player.position);
+    }
+}
+
+// Field-by-field so struct padding never leaks into the hash
+static void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+}
+
+template <typename T>
+static void HashValue(uint64_t& hash, const T& value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+uint64_t HashGameState(const GameState& state) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const Player& player = state.player;
+    HashValue(hash, player.position.x);
+    HashValue(hash, player.position.y);
+    HashValue(hash, player.velocity.x);
+    HashValue(hash, player.velocity.y);
+    HashValue(hash, player.bounds.x);
+    HashValue(hash, player.bounds.y);
+    HashValue(hash, player.isJumping);
+    HashValue(hash, player.isFacingRight);
+    HashValue(hash, player.invulnerabilityTimer);
+    HashValue(hash, player.coyoteTimer);
+    HashValue(hash, player.jumpBufferTimer);
+    HashValue(hash, player.jumpHoldTimer);
+    HashValue(hash, player.isJumpHeld);
+    HashValue(hash, player.lastSafePosition.x);
+    HashValue(hash, player.lastSafePosition.y);
+
+    const BatSwarm& bats = state.bats;
+    HashValue(hash, bats.count);
+    HashBytes(hash, bats.positionX.data(), bats.count * sizeof(float));
+    HashBytes(hash, bats.positionY.data(), bats.count * sizeof(float));
+    HashBytes(hash, bats.velocityX.data(), bats.count * sizeof(float));
+    HashBytes(hash, bats.velocityY.data(), bats.count * sizeof(float));
+    HashBytes(hash, bats.respawnTimer.data(), bats.count * sizeof(int32_t));
+    HashBytes(hash, bats.frameCounter.data(), bats.count * sizeof(int32_t));
+    HashBytes(hash, bats.currentFrame.data(), bats.count * sizeof(int32_t));
+
+    HashValue(hash, state.cameraX);
+    HashValue(hash, state.nextBatZone);
+    HashValue(hash, state.flag.reached);
+    HashValue(hash, state.flag.waveTimer);
+    HashValue(hash, state.score.bat);
+    HashValue(hash, state.score.player);
+    HashValue(hash, state.levelComplete);
+    HashValue(hash, state.transitionTimer);
+    HashValue(hash, state.previousButtons);
+    HashValue(hash, state.tick);
+    HashValue(hash, state.rng.state);
+    return hash;
+}
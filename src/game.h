@@ -0,0 +1,159 @@
+#pragma once
+
+#include "raylib.h" // Vector2 / Rectangle only - the simulation never calls into raylib
+#include "bat_swarm.h"
+#include "contact_sweep.h"
+#include "platform_grid.h"
+#include "spawn_sampler.h"
+#include "world.h"
+#include <cstdint>
+#include <vector>
+
+// Game constants (speeds, forces and timers are per simulation tick)
+const int ticksPerSecond = 60;             // Fixed simulation rate, independent of the display rate
+const int screenWidth = 1280;
+const int screenHeight = 720;
+const float playerSpeed = 5.0f;
+const float gravity = 0.4f;                // Reduced gravity for smoother falling
+const float jumpForce = -10.0f;            // Reduced initial jump force
+const float jumpHoldForce = -0.5f;         // Additional force when holding jump button
+const float maxJumpHoldTime = 15.0f;       // Maximum frames to apply additional jump force
+const float airControlFactor = 0.7f;       // Reduced control in air (0.0 to 1.0)
+const float terminalVelocity = 12.0f;      // Maximum falling speed
+const float collisionSkin = 0.001f;        // Float tolerance for "touching" in the collision sweep
+const int coyoteTimeFrames = 6;            // Frames where player can still jump after leaving platform
+const int jumpBufferFrames = 6;            // Frames where jump input is remembered before landing
+const int tileSize = 64;  // Size of each tile in pixels
+const float batScale = 0.1875f; // Bat scale factor
+const Vector2 defaultPlayerSpriteSize = {200, 157}; // player1.png, for headless runs without the art
+const Vector2 defaultBatFrameSize = {534, 419};     // One frame of the default bat sheet
+const float batSpeed = 2.0f; // Bat movement speed
+const int invulnerabilityFrames = 60; // 1 second at 60 FPS
+const int batRespawnFrames = 30;      // Half a second at 60 FPS
+const int batAnimationFrames = 8;     // Frames in the bat fly cycle
+const int maxBats = 6;                // Level bat zones stop spawning once this many are out
+const Vector2 flagSize = {40, 60};    // Flag collision bounds
+const int levelTransitionTicks = ticksPerSecond * 2; // From reaching the flag to the next level
+
+// Bump whenever Step/InitGame change behavior, so old recordings are rejected
+// instead of silently diverging. That includes GenerateLevel: a recording only
+// stores the seed, so a different level for the same seed is a different game.
+const uint32_t simulationVersion = 7;
+
+// Buttons sampled for one simulation tick (bit flags for InputFrame::buttons)
+enum InputButton : uint8_t {
+    INPUT_LEFT  = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_SPACE = 1 << 2,
+    INPUT_UP    = 1 << 3
+};
+
+// Held-key state for one simulation tick; presses are derived from the previous tick
+struct InputFrame {
+    uint8_t buttons;
+};
+
+// Small deterministic PRNG (xorshift64*) so the simulation does not depend on raylib's global generator
+struct Rng {
+    uint64_t state;
+};
+
+// Player structure
+struct Player {
+    Vector2 position;
+    Vector2 velocity;
+    float speed;
+    bool isJumping;
+    Rectangle bounds;
+    bool isFacingRight;  // To track player direction for sprite flipping
+    int invulnerabilityTimer; // Timer for invulnerability after collision
+    int coyoteTimer;          // Timer for coyote time
+    int jumpBufferTimer;      // Timer for jump buffer
+    int jumpHoldTimer;        // Timer for variable jump height
+    bool isJumpHeld;          // Whether jump button is being held
+    Vector2 lastSafePosition; // Last place the player stood on ground; falling off the level returns here
+};
+
+// Flag structure
+struct Flag {
+    Vector2 position;
+    Rectangle bounds;
+    bool reached;
+    float waveTimer;
+};
+
+// Score structure
+struct Score {
+    int bat;    // Points for the bat
+    int player; // Points for the player
+};
+
+// Everything the game rules read or write; no textures, window or audio handles
+struct GameState {
+    Player player;
+    BatSwarm bats;
+    Flag flag;
+    Score score;
+    World world;                        // Streaming level; only chunks near the camera are resident
+    float cameraX;                      // Left edge of the view in world coordinates
+    std::vector<Platform> platforms;    // Resident chunks' platforms, rebuilt when the world streams
+    PlatformGrid platformGrid;          // Broadphase over platforms, rebuilt with them
+    std::vector<int> collisionCandidates; // Scratch list reused every tick
+    ContactSweep batContacts;           // Bat vs player broadphase, kept sorted between ticks
+    SpawnSampler batSpawns;             // Respawn cells away from the player, reused every tick
+    int nextBatZone;                    // First of world.batZones the camera has not reached yet
+    bool levelComplete;                 // Flag reached; play is frozen until the next level is swapped in
+    int transitionTimer;                // Ticks left before the next level is due
+    uint8_t previousButtons; // Buttons held last tick, for IsKeyPressed-style edges
+    uint64_t tick;           // Number of Step calls since InitGame
+    Rng rng;
+};
+
+// Seed the generator; any seed (including 0) is valid
+void SeedRng(Rng& rng, uint64_t seed);
+
+// Random integer in [min, max], inclusive like raylib's GetRandomValue
+int RandomInt(Rng& rng, int min, int max);
+
+// Function to respawn a bat at a random position in the top third of area (the
+// visible part of the world), away from the players' positions. Sampled from
+// spawns in constant time; bats respawned together in a tick share its update.
+void RespawnBat(BatSwarm& bats, int index, const Vector2* players, int playerCount, Rng& rng, Rectangle area,
+                SpawnSampler& spawns);
+
+// Generate the level for seed and place player, bat and flag. Sprite sizes are
+// the unscaled texture dimensions; they only determine collision bounds. The
+// level is levelChunks screens long, ending with the flag staircase.
+void InitGame(GameState& state, unsigned int seed, Vector2 playerSpriteSize, Vector2 batFrameSize,
+              int levelChunks = defaultLevelChunks);
+
+// Same, on a baked level (generated and baked, or straight from a mapped level file)
+void InitGame(GameState& state, const LevelView& level, Vector2 playerSpriteSize, Vector2 batFrameSize);
+
+// Advance the simulation by exactly one fixed tick
+void Step(GameState& state, InputFrame input);
+
+// Load/evict chunks around state.cameraX and rebuild the resident platform
+// list and grid if they changed. Step does this itself; call it after moving
+// the camera some other way (restoring a rewound tick).
+void StreamLevel(GameState& state);
+
+// The flag was reached levelTransitionTicks ago; time to start the next level
+// (see LevelSequence), keeping the score
+bool LevelTransitionDue(const GameState& state);
+
+// Player movement and platform collision for one tick, without the camera,
+// streaming, bats or flag. Step runs the same code; level tools use it to try
+// jumps with the real physics on a state whose platforms and grid they filled.
+void StepPlayer(GameState& state, InputFrame input);
+
+// Free-flight path of a player who starts standing on the ground and holds
+// buttons from then on: arc[t] is the offset from the take-off position after
+// t + 1 ticks. With coyoteTicks > 0 the player first runs off the edge for that
+// many ticks and jumps in coyote time. Uses the same movement code as Step,
+// minus collisions, so level tools can measure what the real physics can jump.
+void TraceJumpArc(uint8_t buttons, int ticks, std::vector<Vector2>& arc, int coyoteTicks = 0);
+
+// FNV-1a hash of every field Step reads or writes; equal hashes after the same
+// inputs mean the runs were bit-identical
+uint64_t HashGameState(const GameState& state);
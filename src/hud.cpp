@@ -0,0 +1,227 @@
+#include "hud.h"
+#include <cmath>
+#include <cstring>
+
+void ClearHudText(HudText& text) {
+    text.length = 0;
+    text.chars[0] = '\0';
+}
+
+void AppendHudText(HudText& text, const char* chars) {
+    while (*chars != '\0' && text.length < hudTextCapacity - 1) {
+        text.chars[text.length++] = *chars++;
+    }
+    text.chars[text.length] = '\0';
+}
+
+void AppendHudInt(HudText& text, int value) {
+    // Digits come out last first; widen so INT_MIN negates safely
+    char digits[12];
+    int count = 0;
+    long long magnitude = value < 0 ? -static_cast<long long>(value) : value;
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) digits[count++] = '-';
+    while (count > 0 && text.length < hudTextCapacity - 1) {
+        text.chars[text.length++] = digits[--count];
+    }
+    text.chars[text.length] = '\0';
+}
+
+void AppendHudTenths(HudText& text, float value) {
+    long tenths = lroundf(value * 10.0f);
+    if (tenths < 0) {
+        AppendHudText(text, "-");
+        tenths = -tenths;
+    }
+    AppendHudInt(text, static_cast<int>(tenths / 10));
+    char fraction[3] = {'.', static_cast<char>('0' + tenths % 10), '\0'};
+    AppendHudText(text, fraction);
+}
+
+static void SetHudLine(HudLine& line, int x, int y, bool alignRight, int fontSize, Color color) {
+    ClearHudText(line.text);
+    line.x = x;
+    line.y = y;
+    line.alignRight = alignRight;
+    line.fontSize = fontSize;
+    line.color = color;
+    line.drawn = {0, 0, 0, 0};
+    line.dirty = true;
+}
+
+static Rectangle MeasureHudLine(const HudLine& line) {
+    int width = MeasureText(line.text.chars, line.fontSize);
+    int x = line.alignRight ? line.x - width : line.x;
+    return {static_cast<float>(x), static_cast<float>(line.y), static_cast<float>(width),
+            static_cast<float>(line.fontSize)};
+}
+
+// Clear the rectangles of the changed lines and draw the text of every line in them
+static void RedrawHudLayer(Hud& hud) {
+    Rectangle cleared[HUD_LINE_COUNT];
+    int clearedCount = 0;
+    for (const HudLine& line : hud.lines) {
+        if (line.dirty && line.drawn.width > 0) cleared[clearedCount++] = line.drawn;
+    }
+
+    BeginTextureMode(hud.layer);
+    for (int i = 0; i < clearedCount; i++) {
+        BeginScissorMode(static_cast<int>(cleared[i].x), static_cast<int>(cleared[i].y),
+                         static_cast<int>(cleared[i].width), static_cast<int>(cleared[i].height));
+        ClearBackground(BLANK);
+        EndScissorMode();
+    }
+    for (HudLine& line : hud.lines) {
+        bool touched = line.dirty;
+        for (int i = 0; i < clearedCount && !touched; i++) {
+            touched = CheckCollisionRecs(line.drawn, cleared[i]);
+        }
+        if (!touched) continue;
+        line.drawn = MeasureHudLine(line);
+        DrawText(line.text.chars, static_cast<int>(line.drawn.x), line.y, line.fontSize, line.color);
+        line.dirty = false;
+    }
+    EndTextureMode();
+}
+
+static HudLabel MakeHudLabel(const char* text, int fontSize, Color color) {
+    HudLabel label;
+    label.width = MeasureText(text, fontSize);
+    label.height = fontSize;
+    label.texture = LoadRenderTexture(label.width, label.height);
+    BeginTextureMode(label.texture);
+    ClearBackground(BLANK);
+    DrawText(text, 0, 0, fontSize, color);
+    EndTextureMode();
+    return label;
+}
+
+// Render textures are stored upside down; a negative source height flips them back
+static void DrawRenderTexture(const RenderTexture2D& target, Vector2 position) {
+    Rectangle source = {0, 0, static_cast<float>(target.texture.width), -static_cast<float>(target.texture.height)};
+    DrawTextureRec(target.texture, source, {floorf(position.x), floorf(position.y)}, WHITE);
+}
+
+static void BuildLevelCompleteScreen(Hud& hud, int nextLevel) {
+    BeginTextureMode(hud.levelComplete);
+    // Clearing (not drawing) the dimming keeps its alpha exact in the texture
+    ClearBackground(Fade(BLACK, 0.7f));
+
+    const char* winText = "YOU WIN FREER";
+    int fontSize = 60;
+    int textWidth = MeasureText(winText, fontSize);
+    DrawText(winText, screenWidth/2 - textWidth/2, screenHeight/2 - fontSize/2, fontSize, YELLOW);
+
+    HudText nextText;
+    ClearHudText(nextText);
+    AppendHudText(nextText, "Level ");
+    AppendHudInt(nextText, nextLevel);
+    AppendHudText(nextText, " coming up...");
+    int smallFontSize = 30;
+    int smallTextWidth = MeasureText(nextText.chars, smallFontSize);
+    DrawText(nextText.chars, screenWidth/2 - smallTextWidth/2, screenHeight/2 + fontSize, smallFontSize, WHITE);
+    EndTextureMode();
+    hud.levelCompleteNext = nextLevel;
+}
+
+void InitHud(Hud& hud, const char* controls, Vector2 playerTextureSize) {
+    hud.layer = LoadRenderTexture(screenWidth, screenHeight);
+    BeginTextureMode(hud.layer);
+    ClearBackground(BLANK);
+    EndTextureMode();
+
+    SetHudLine(hud.lines[HUD_CONTROLS], 20, 20, false, 20, BLACK);
+    AppendHudText(hud.lines[HUD_CONTROLS].text, controls);
+    SetHudLine(hud.lines[HUD_TEXTURE], 20, 50, false, 20, RED);
+    AppendHudText(hud.lines[HUD_TEXTURE].text, "Player Texture: ");
+    AppendHudInt(hud.lines[HUD_TEXTURE].text, static_cast<int>(playerTextureSize.x));
+    AppendHudText(hud.lines[HUD_TEXTURE].text, "x");
+    AppendHudInt(hud.lines[HUD_TEXTURE].text, static_cast<int>(playerTextureSize.y));
+    SetHudLine(hud.lines[HUD_JUMP], 20, 80, false, 20, DARKGREEN);
+    SetHudLine(hud.lines[HUD_SCORE], screenWidth - 20, 20, true, 20, BLACK);
+
+    hud.flagReached = MakeHudLabel("FLAG REACHED!", 16, GREEN);
+    hud.invulnerable = MakeHudLabel("INVULNERABLE!", 16, YELLOW);
+    hud.levelComplete = LoadRenderTexture(screenWidth, screenHeight);
+    hud.levelCompleteNext = -1;
+
+    // Impossible values, so the first UpdateHud fills every line
+    hud.levelIndex = -1;
+    hud.score = {-1, -1};
+    hud.isJumping = false;
+    hud.velocityTenths = -1;
+    hud.coyoteTimer = -1;
+    hud.jumpBufferTimer = -1;
+}
+
+void UpdateHud(Hud& hud, const Player& player, const Score& score, int levelIndex, bool levelComplete) {
+    int velocityTenths = static_cast<int>(lroundf(player.velocity.y * 10.0f));
+    if (player.isJumping != hud.isJumping || velocityTenths != hud.velocityTenths ||
+        player.coyoteTimer != hud.coyoteTimer || player.jumpBufferTimer != hud.jumpBufferTimer) {
+        hud.isJumping = player.isJumping;
+        hud.velocityTenths = velocityTenths;
+        hud.coyoteTimer = player.coyoteTimer;
+        hud.jumpBufferTimer = player.jumpBufferTimer;
+        HudLine& line = hud.lines[HUD_JUMP];
+        ClearHudText(line.text);
+        AppendHudText(line.text, player.isJumping ? "Jump: YES | Velocity Y: " : "Jump: NO | Velocity Y: ");
+        AppendHudTenths(line.text, player.velocity.y);
+        AppendHudText(line.text, " | Coyote: ");
+        AppendHudInt(line.text, player.coyoteTimer);
+        AppendHudText(line.text, " | Buffer: ");
+        AppendHudInt(line.text, player.jumpBufferTimer);
+        line.dirty = true;
+    }
+
+    if (levelIndex != hud.levelIndex || score.bat != hud.score.bat || score.player != hud.score.player) {
+        hud.levelIndex = levelIndex;
+        hud.score = score;
+        HudLine& line = hud.lines[HUD_SCORE];
+        ClearHudText(line.text);
+        AppendHudText(line.text, "LEVEL ");
+        AppendHudInt(line.text, levelIndex + 1);
+        AppendHudText(line.text, " | BAT: ");
+        AppendHudInt(line.text, score.bat);
+        AppendHudText(line.text, " | PLAYER: ");
+        AppendHudInt(line.text, score.player);
+        line.dirty = true;
+    }
+
+    for (const HudLine& line : hud.lines) {
+        if (line.dirty) {
+            RedrawHudLayer(hud);
+            break;
+        }
+    }
+    if (levelComplete && hud.levelCompleteNext != levelIndex + 2) {
+        BuildLevelCompleteScreen(hud, levelIndex + 2);
+    }
+}
+
+void SetHudControls(Hud& hud, const char* controls) {
+    HudLine& line = hud.lines[HUD_CONTROLS];
+    HudText text;
+    ClearHudText(text);
+    AppendHudText(text, controls);
+    if (strcmp(text.chars, line.text.chars) == 0) return;
+    line.text = text;
+    line.dirty = true;
+}
+
+void DrawHud(const Hud& hud, bool flagReached, Vector2 flagLabelPosition, bool invulnerable,
+             Vector2 invulnerableLabelPosition, bool levelComplete) {
+    if (flagReached) DrawRenderTexture(hud.flagReached.texture, flagLabelPosition);
+    if (invulnerable) DrawRenderTexture(hud.invulnerable.texture, invulnerableLabelPosition);
+    DrawRenderTexture(hud.layer, {0, 0});
+    if (levelComplete) DrawRenderTexture(hud.levelComplete, {0, 0});
+}
+
+void UnloadHud(Hud& hud) {
+    UnloadRenderTexture(hud.layer);
+    UnloadRenderTexture(hud.flagReached.texture);
+    UnloadRenderTexture(hud.invulnerable.texture);
+    UnloadRenderTexture(hud.levelComplete);
+}
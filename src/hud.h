@@ -0,0 +1,80 @@
+#pragma once
+
+#include "game.h"
+#include "raylib.h"
+
+const int hudTextCapacity = 96;
+
+// Fixed-size text built without allocation or printf; whatever does not fit is dropped
+struct HudText {
+    char chars[hudTextCapacity];
+    int length;
+};
+
+void ClearHudText(HudText& text);
+void AppendHudText(HudText& text, const char* chars);
+void AppendHudInt(HudText& text, int value);
+void AppendHudTenths(HudText& text, float value); // One decimal, like %.1f
+
+// Screen-space text lines kept in the HUD layer
+enum HudLineId {
+    HUD_CONTROLS, // Controls help (or the bot notice)
+    HUD_TEXTURE,  // Player texture size
+    HUD_JUMP,     // Jump state, vertical velocity, coyote and buffer timers
+    HUD_SCORE,    // Level and score, right-aligned
+    HUD_LINE_COUNT
+};
+
+struct HudLine {
+    HudText text;
+    int x, y;        // Left edge, or right edge when alignRight
+    bool alignRight;
+    int fontSize;
+    Color color;
+    Rectangle drawn; // Where the text was last rasterized in the layer
+    bool dirty;      // Text changed since it was rasterized
+};
+
+// A piece of text rasterized once into its own texture, then drawn wherever it is needed
+struct HudLabel {
+    RenderTexture2D texture;
+    int width, height;
+};
+
+// Retained HUD: text is rasterized into render textures only when what it shows
+// changes, and every frame just draws those textures. The lines share one
+// screen-sized layer in which only the changed lines' rectangles are cleared
+// and redrawn; the labels that follow the flag and the player are drawn once.
+struct Hud {
+    RenderTexture2D layer;
+    HudLine lines[HUD_LINE_COUNT];
+    HudLabel flagReached;
+    HudLabel invulnerable;
+    RenderTexture2D levelComplete; // Level complete screen; rebuilt when the next level number changes
+    int levelCompleteNext;         // Level number levelComplete announces, or -1
+
+    // Values the lines show, to tell when they change
+    int levelIndex;
+    Score score;
+    bool isJumping;
+    int velocityTenths;
+    int coyoteTimer;
+    int jumpBufferTimer;
+};
+
+// Create the textures and rasterize the static text. Needs the window.
+void InitHud(Hud& hud, const char* controls, Vector2 playerTextureSize);
+
+// Re-rasterize the lines whose values changed since the last call. Call outside
+// BeginMode2D (it switches to the HUD's render textures when there is work).
+void UpdateHud(Hud& hud, const Player& player, const Score& score, int levelIndex, bool levelComplete);
+
+// Replace the controls line (the versus match status uses it); a no-op when the text is the same
+void SetHudControls(Hud& hud, const char* controls);
+
+// Draw the HUD in screen space: the labels where requested, the lines, and the
+// level complete screen on top while it is up
+void DrawHud(const Hud& hud, bool flagReached, Vector2 flagLabelPosition, bool invulnerable,
+             Vector2 invulnerableLabelPosition, bool levelComplete);
+
+void UnloadHud(Hud& hud);
@@ -0,0 +1,147 @@
+#include "input_recording.h"
+#include <cstdio>
+#include <cstring>
+
+// File layout (little-endian):
+//   RecordingHeader
+//   runs: button byte, run length as LEB128 varint (repeated until tickCount is covered)
+struct RecordingHeader {
+    char magic[4];        // "FTRC"
+    uint32_t version;     // File layout version
+    uint32_t simVersion;  // simulationVersion of the writer
+    uint32_t seed;
+    float playerSpriteSize[2];
+    float batFrameSize[2];
+    uint64_t tickCount;
+    uint64_t finalHash;
+};
+
+static const char recordingMagic[4] = {'F', 'T', 'R', 'C'};
+static const uint32_t recordingVersion = 1;
+static const uint64_t maxRecordingTicks = 24ull * 60 * 60 * ticksPerSecond; // A day of play
+
+void BeginInputRecording(InputRecording& recording, unsigned int seed,
+                         Vector2 playerSpriteSize, Vector2 batFrameSize) {
+    recording.seed = seed;
+    recording.playerSpriteSize = playerSpriteSize;
+    recording.batFrameSize = batFrameSize;
+    recording.buttons.clear();
+    recording.finalHash = 0;
+}
+
+static void WriteVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool ReadVarint(const std::vector<uint8_t>& in, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < in.size(); shift += 7) {
+        uint8_t byte = in[offset++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool SaveInputRecording(const InputRecording& recording, const std::string& path) {
+    RecordingHeader header = {};
+    memcpy(header.magic, recordingMagic, sizeof(header.magic));
+    header.version = recordingVersion;
+    header.simVersion = simulationVersion;
+    header.seed = recording.seed;
+    header.playerSpriteSize[0] = recording.playerSpriteSize.x;
+    header.playerSpriteSize[1] = recording.playerSpriteSize.y;
+    header.batFrameSize[0] = recording.batFrameSize.x;
+    header.batFrameSize[1] = recording.batFrameSize.y;
+    header.tickCount = recording.buttons.size();
+    header.finalHash = recording.finalHash;
+
+    std::vector<uint8_t> runs;
+    for (size_t i = 0; i < recording.buttons.size();) {
+        size_t end = i + 1;
+        while (end < recording.buttons.size() && recording.buttons[end] == recording.buttons[i]) end++;
+        runs.push_back(recording.buttons[i]);
+        WriteVarint(runs, end - i);
+        i = end;
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (runs.empty() || fwrite(runs.data(), 1, runs.size(), file) == runs.size());
+    return fclose(file) == 0 && ok;
+}
+
+bool LoadInputRecording(InputRecording& recording, const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    RecordingHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1;
+    std::vector<uint8_t> runs;
+    uint8_t chunk[4096];
+    size_t read;
+    while (ok && (read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        runs.insert(runs.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    if (!ok || memcmp(header.magic, recordingMagic, sizeof(header.magic)) != 0 ||
+        header.version != recordingVersion) {
+        fprintf(stderr, "%s: not a findtreasure recording\n", path.c_str());
+        return false;
+    }
+    if (header.simVersion != simulationVersion) {
+        fprintf(stderr, "%s: recorded with simulation version %u, this build is %u\n",
+                path.c_str(), header.simVersion, simulationVersion);
+        return false;
+    }
+
+    // Check the runs add up to tickCount before allocating it; a run length is
+    // only trusted this far, not the header
+    uint64_t runTicks = 0;
+    size_t offset = 0;
+    while (offset < runs.size() && runTicks < header.tickCount) {
+        offset++;
+        uint64_t length;
+        if (!ReadVarint(runs, offset, length) || length > header.tickCount - runTicks) break;
+        runTicks += length;
+    }
+    if (runTicks != header.tickCount) {
+        fprintf(stderr, "%s: truncated recording\n", path.c_str());
+        return false;
+    }
+    if (header.tickCount > maxRecordingTicks) {
+        fprintf(stderr, "%s: recording is longer than %llu ticks\n", path.c_str(),
+                static_cast<unsigned long long>(maxRecordingTicks));
+        return false;
+    }
+
+    recording.seed = header.seed;
+    recording.playerSpriteSize = {header.playerSpriteSize[0], header.playerSpriteSize[1]};
+    recording.batFrameSize = {header.batFrameSize[0], header.batFrameSize[1]};
+    recording.finalHash = header.finalHash;
+    recording.buttons.clear();
+    recording.buttons.reserve(header.tickCount);
+    offset = 0;
+    while (recording.buttons.size() < header.tickCount) {
+        uint8_t value = runs[offset++];
+        uint64_t length;
+        ReadVarint(runs, offset, length);
+        recording.buttons.insert(recording.buttons.end(), length, value);
+    }
+    return true;
+}
+
+void ReplayInputRecording(GameState& state, const InputRecording& recording) {
+    static thread_local LevelSequence sequence;
+    BeginLevelSequence(sequence, state, recording.seed, recording.playerSpriteSize, recording.batFrameSize);
+    for (uint8_t buttons : recording.buttons) {
+        Step(state, {buttons});
+        UpdateLevelSequence(sequence, state);
+    }
+    EndLevelSequence(sequence);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "game.h"
+#include "level_sequence.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything needed to reproduce a run bit-for-bit: InitGame's arguments plus
+// one button byte per Step. Stored on disk as a small header followed by the
+// buttons run-length encoded (held keys compress to a few bytes per second).
+struct InputRecording {
+    unsigned int seed;
+    Vector2 playerSpriteSize;
+    Vector2 batFrameSize;
+    std::vector<uint8_t> buttons; // buttons[i] is the input for tick i
+    uint64_t finalHash;           // HashGameState after the last tick (0 = not recorded)
+};
+
+// Start an empty recording for a game initialized with these arguments
+void BeginInputRecording(InputRecording& recording, unsigned int seed,
+                         Vector2 playerSpriteSize, Vector2 batFrameSize);
+
+bool SaveInputRecording(const InputRecording& recording, const std::string& path);
+
+// Fails on a bad/truncated file or one written by a different simulationVersion
+bool LoadInputRecording(InputRecording& recording, const std::string& path);
+
+// Start a level sequence from the recording's header, as the game does, then
+// Step through every recorded tick, moving on to the next level at each flag
+void ReplayInputRecording(GameState& state, const InputRecording& recording);
@@ -0,0 +1,117 @@
+#include "level_analyzer.h"
+#include <algorithm>
+#include <cmath>
+
+void BuildJumpEnvelope(JumpEnvelope& envelope) {
+    // Full jump held with right held, taken off the ground or in any tick of
+    // coyote time after running off an edge. Holding jump longer only ever
+    // raises the arc, so these bound every shorter jump from above.
+    const int arcTicks = ticksPerSecond * 3;
+    std::vector<std::vector<Vector2>> arcs(coyoteTimeFrames);
+    envelope.maxRise = 0;
+    for (int coyote = 0; coyote < coyoteTimeFrames; coyote++) {
+        TraceJumpArc(INPUT_RIGHT | INPUT_SPACE, arcTicks, arcs[coyote], coyote);
+        arcs[coyote].insert(arcs[coyote].begin(), {0, 0}); // Landing straight back where it took off
+        for (const Vector2& offset : arcs[coyote]) {
+            envelope.maxRise = std::max(envelope.maxRise, -offset.y);
+        }
+    }
+
+    // Bin every arc point by the whole pixel below it, then sweep down from the
+    // top: a surface at some height is reachable as far out as any point at or
+    // above it, because the player comes down through that height further out
+    envelope.maxDrop = screenHeight;
+    int rows = envelope.maxDrop + static_cast<int>(std::floor(envelope.maxRise)) + 1;
+    envelope.reach.assign(rows, -1.0f);
+    for (const auto& arc : arcs) {
+        for (const Vector2& offset : arc) {
+            int row = std::max(0, envelope.maxDrop + static_cast<int>(std::floor(-offset.y)));
+            envelope.reach[row] = std::max(envelope.reach[row], offset.x);
+        }
+    }
+    for (int row = rows - 2; row >= 0; row--) {
+        envelope.reach[row] = std::max(envelope.reach[row], envelope.reach[row + 1]);
+    }
+}
+
+const JumpEnvelope& GetJumpEnvelope() {
+    static const JumpEnvelope envelope = [] {
+        JumpEnvelope built;
+        BuildJumpEnvelope(built);
+        return built;
+    }();
+    return envelope;
+}
+
+float JumpReach(const JumpEnvelope& envelope, float rise) {
+    // Round the rise up so a surface between two rows needs the higher one
+    int row = envelope.maxDrop + static_cast<int>(std::ceil(rise));
+    if (row >= static_cast<int>(envelope.reach.size())) return -1.0f;
+    return envelope.reach[std::max(row, 0)];
+}
+
+bool AnalyzeLevel(LevelAnalyzer& analyzer, const std::vector<Platform>& platforms, Vector2 spawn,
+                  Vector2 flagPosition, Vector2 playerSize, LevelAnalysis& analysis) {
+    analysis.solvable = false;
+    analysis.path.clear();
+    analysis.reachableCount = 0;
+    int count = static_cast<int>(platforms.size());
+    if (count == 0) return false;
+
+    const JumpEnvelope& envelope = GetJumpEnvelope();
+    BuildPlatformGrid(analyzer.grid, platforms);
+
+    // Start on the platform under the spawn point
+    int start = -1;
+    for (int i = 0; i < count && start < 0; i++) {
+        const Rectangle& r = platforms[i].rect;
+        if (fabsf(r.y - spawn.y) <= collisionSkin && spawn.x < r.x + r.width && spawn.x + playerSize.x > r.x) {
+            start = i;
+        }
+    }
+    if (start < 0) return false;
+
+    // Standing somewhere on r, the player's box can overlap the flag
+    Rectangle flag = {flagPosition.x, flagPosition.y, flagSize.x, flagSize.y};
+    auto reachesFlag = [&](const Rectangle& r) {
+        return r.x - playerSize.x < flag.x + flag.width && r.x + r.width + playerSize.x > flag.x && r.y > flag.y &&
+               r.y - playerSize.y < flag.y + flag.height;
+    };
+
+    analyzer.parent.assign(count, -2);
+    analyzer.queue.clear();
+    analyzer.queue.push_back(start);
+    analyzer.parent[start] = -1;
+    int goal = -1;
+    for (size_t head = 0; head < analyzer.queue.size(); head++) {
+        int from = analyzer.queue[head];
+        const Rectangle& a = platforms[from].rect;
+        if (goal < 0 && reachesFlag(a)) goal = from; // Breadth-first, so the first one found is the closest
+
+        // Everything within reach sideways, from the apex down to the bottom of the screen
+        float maxReach = JumpReach(envelope, a.y - screenHeight) + playerSize.x;
+        Rectangle area = {a.x - maxReach, a.y - envelope.maxRise, a.width + 2 * maxReach,
+                          envelope.maxRise + screenHeight - a.y};
+        QueryPlatformGrid(analyzer.grid, area, analyzer.candidates);
+        for (int to : analyzer.candidates) {
+            if (analyzer.parent[to] != -2) continue;
+            const Rectangle& b = platforms[to].rect;
+            float reach = JumpReach(envelope, a.y - b.y);
+            if (reach < 0) continue;
+            // Gap between the furthest take-off and the nearest landing spot, either way
+            float needed = std::max((b.x - playerSize.x) - (a.x + a.width), (a.x - playerSize.x) - (b.x + b.width));
+            if (needed > 0 && needed >= reach) continue;
+            analyzer.parent[to] = from;
+            analyzer.queue.push_back(to);
+        }
+    }
+    analysis.reachableCount = static_cast<int>(analyzer.queue.size());
+    if (goal < 0) return false;
+
+    for (int at = goal; at >= 0; at = analyzer.parent[at]) {
+        analysis.path.push_back(at);
+    }
+    std::reverse(analysis.path.begin(), analysis.path.end());
+    analysis.solvable = true;
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "game.h"
+#include <vector>
+
+// Where a jump can land, relative to where it took off, precomputed once from
+// the movement constants (jumpForce, jumpHoldForce, maxJumpHoldTime,
+// airControlFactor, gravity, coyote time) by running TraceJumpArc. Air control
+// sets the horizontal speed directly, so anything closer than the furthest
+// reach at a height is reachable too.
+struct JumpEnvelope {
+    float maxRise;            // Apex height of the highest jump
+    int maxDrop;              // Deepest drop tabulated; deeper drops use its reach
+    std::vector<float> reach; // Index maxDrop + rise (whole pixels): furthest horizontal distance
+};
+
+void BuildJumpEnvelope(JumpEnvelope& envelope);
+
+// The envelope for the game's constants, built on first use
+const JumpEnvelope& GetJumpEnvelope();
+
+// Furthest horizontal distance at which the player can come down on a surface
+// rise pixels above the take-off height (negative = below); -1 if it is too high
+float JumpReach(const JumpEnvelope& envelope, float rise);
+
+// Result of AnalyzeLevel. path lists platform indices from the one under the
+// spawn to one the flag stands on, with the fewest jumps or drops.
+struct LevelAnalysis {
+    bool solvable;
+    std::vector<int> path;
+    int reachableCount; // Platforms the player can get onto at all
+};
+
+// Scratch memory for AnalyzeLevel; keep one per thread and reuse it
+struct LevelAnalyzer {
+    PlatformGrid grid;
+    std::vector<int> candidates;
+    std::vector<int> parent; // Per platform: previous platform on the search tree, -2 = unvisited
+    std::vector<int> queue;
+};
+
+// Breadth-first search over platforms, with an edge wherever the envelope says
+// the player can get from one platform's top onto another's. Arcs are not
+// checked against platforms in the way, so a ceiling that blocks the only
+// jump is not noticed. spawn is the player's feet; flagPosition the flag's
+// top-left.
+bool AnalyzeLevel(LevelAnalyzer& analyzer, const std::vector<Platform>& platforms, Vector2 spawn,
+                  Vector2 flagPosition, Vector2 playerSize, LevelAnalysis& analysis);
@@ -0,0 +1,252 @@
+#include "level_file.h"
+#include <cstdio>
+#include <cstring>
+
+// File layout (little-endian, every array starts 16-byte aligned):
+//   LevelFileHeader
+//   LevelFileEntry[levelCount]
+//   per level: Platform[platformCount], uint32_t chunkStart[chunkCount + 1],
+//              Rectangle batZones[batZoneCount], uint8_t tiles[platformCount]
+struct LevelFileHeader {
+    char magic[4];    // "FTLV"
+    uint32_t version; // File layout version
+    uint32_t levelCount;
+    float chunkWidth; // Platforms are cut at multiples of this; a build with other chunks cannot use them
+};
+
+struct LevelFileEntry {
+    uint64_t seed;
+    uint32_t chunkCount;
+    float width;
+    float playerSpawn[2];
+    float flagPosition[2];
+    uint32_t platformCount;
+    uint32_t batZoneCount;
+    uint64_t platformsOffset;
+    uint64_t chunkStartOffset;
+    uint64_t batZonesOffset;
+    uint64_t tilesOffset;
+};
+
+static const char levelFileMagic[4] = {'F', 'T', 'L', 'V'};
+static const uint32_t levelFileVersion = 1;
+static const uint64_t levelFileAlignment = 16;
+
+static const char* const tileNames[TILE_KIND_COUNT] = {"ground", "ledge", "stair"};
+
+static float LevelChunkWidth() {
+    return static_cast<float>(worldChunkTiles * tileSize);
+}
+
+static const LevelFileEntry* LevelFileEntries(const MappedFile& mapped) {
+    return reinterpret_cast<const LevelFileEntry*>(mapped.data + sizeof(LevelFileHeader));
+}
+
+// An array of count items of itemSize bytes at offset lies inside the file and is aligned
+static bool ArrayInFile(const MappedFile& mapped, uint64_t offset, uint64_t count, uint64_t itemSize) {
+    return offset % levelFileAlignment == 0 && offset <= mapped.size && count <= (mapped.size - offset) / itemSize;
+}
+
+static bool IsValidLevelFile(const MappedFile& mapped) {
+    if (mapped.size < sizeof(LevelFileHeader)) return false;
+    const LevelFileHeader* header = reinterpret_cast<const LevelFileHeader*>(mapped.data);
+    if (memcmp(header->magic, levelFileMagic, sizeof(levelFileMagic)) != 0 || header->version != levelFileVersion ||
+        sizeof(LevelFileHeader) + static_cast<uint64_t>(header->levelCount) * sizeof(LevelFileEntry) > mapped.size) {
+        return false;
+    }
+    const LevelFileEntry* entries = LevelFileEntries(mapped);
+    for (uint32_t i = 0; i < header->levelCount; i++) {
+        const LevelFileEntry& entry = entries[i];
+        if (entry.chunkCount == 0 || !ArrayInFile(mapped, entry.platformsOffset, entry.platformCount, sizeof(Platform)) ||
+            !ArrayInFile(mapped, entry.chunkStartOffset, entry.chunkCount + 1ull, sizeof(uint32_t)) ||
+            !ArrayInFile(mapped, entry.batZonesOffset, entry.batZoneCount, sizeof(Rectangle)) ||
+            !ArrayInFile(mapped, entry.tilesOffset, entry.platformCount, 1)) {
+            return false;
+        }
+        // Chunk slices must be in order and cover exactly the platform array
+        const uint32_t* chunkStart = reinterpret_cast<const uint32_t*>(mapped.data + entry.chunkStartOffset);
+        if (chunkStart[0] != 0 || chunkStart[entry.chunkCount] != entry.platformCount) return false;
+        for (uint32_t c = 0; c < entry.chunkCount; c++) {
+            if (chunkStart[c] > chunkStart[c + 1]) return false;
+        }
+    }
+    return true;
+}
+
+bool OpenLevelFile(LevelFile& file, const std::string& path) {
+    file.levelCount = 0;
+    if (!OpenMappedFile(file.mapped, path)) {
+        fprintf(stderr, "%s: cannot open level file\n", path.c_str());
+        return false;
+    }
+    if (!IsValidLevelFile(file.mapped)) {
+        fprintf(stderr, "%s: not a findtreasure level file (version %u)\n", path.c_str(), levelFileVersion);
+        CloseMappedFile(file.mapped);
+        return false;
+    }
+    const LevelFileHeader* header = reinterpret_cast<const LevelFileHeader*>(file.mapped.data);
+    if (header->chunkWidth != LevelChunkWidth()) {
+        fprintf(stderr, "%s: built for %g-pixel chunks, this build uses %g\n", path.c_str(), header->chunkWidth,
+                LevelChunkWidth());
+        CloseMappedFile(file.mapped);
+        return false;
+    }
+    file.levelCount = static_cast<int>(header->levelCount);
+    return true;
+}
+
+void CloseLevelFile(LevelFile& file) {
+    CloseMappedFile(file.mapped);
+    file.levelCount = 0;
+}
+
+bool GetLevelView(const LevelFile& file, int index, LevelView& view) {
+    if (index < 0 || index >= file.levelCount) return false;
+    const unsigned char* data = file.mapped.data;
+    const LevelFileEntry& entry = LevelFileEntries(file.mapped)[index];
+    view.seed = entry.seed;
+    view.chunkCount = static_cast<int>(entry.chunkCount);
+    view.width = entry.width;
+    view.playerSpawn = {entry.playerSpawn[0], entry.playerSpawn[1]};
+    view.flagPosition = {entry.flagPosition[0], entry.flagPosition[1]};
+    view.platforms = reinterpret_cast<const Platform*>(data + entry.platformsOffset);
+    view.tiles = data + entry.tilesOffset;
+    view.chunkStart = reinterpret_cast<const uint32_t*>(data + entry.chunkStartOffset);
+    view.platformCount = static_cast<int>(entry.platformCount);
+    view.batZones = reinterpret_cast<const Rectangle*>(data + entry.batZonesOffset);
+    view.batZoneCount = static_cast<int>(entry.batZoneCount);
+    return true;
+}
+
+// Append count bytes at the next aligned offset of out and return that offset
+static uint64_t AppendAligned(std::vector<unsigned char>& out, const void* bytes, size_t count) {
+    out.resize((out.size() + levelFileAlignment - 1) / levelFileAlignment * levelFileAlignment);
+    uint64_t offset = out.size();
+    if (count > 0) out.insert(out.end(), static_cast<const unsigned char*>(bytes),
+                              static_cast<const unsigned char*>(bytes) + count);
+    return offset;
+}
+
+bool SaveLevelFile(const std::string& path, const std::vector<Level>& levels) {
+    std::vector<unsigned char> out(sizeof(LevelFileHeader) + levels.size() * sizeof(LevelFileEntry));
+    std::vector<LevelFileEntry> entries(levels.size());
+    BakedLevel baked;
+    for (size_t i = 0; i < levels.size(); i++) {
+        BakeLevel(levels[i], baked);
+        const LevelView& view = baked.view;
+        LevelFileEntry& entry = entries[i];
+        entry = {};
+        entry.seed = view.seed;
+        entry.chunkCount = static_cast<uint32_t>(view.chunkCount);
+        entry.width = view.width;
+        entry.playerSpawn[0] = view.playerSpawn.x;
+        entry.playerSpawn[1] = view.playerSpawn.y;
+        entry.flagPosition[0] = view.flagPosition.x;
+        entry.flagPosition[1] = view.flagPosition.y;
+        entry.platformCount = static_cast<uint32_t>(view.platformCount);
+        entry.batZoneCount = static_cast<uint32_t>(view.batZoneCount);
+        entry.platformsOffset = AppendAligned(out, view.platforms, view.platformCount * sizeof(Platform));
+        entry.chunkStartOffset = AppendAligned(out, view.chunkStart, (view.chunkCount + 1) * sizeof(uint32_t));
+        entry.batZonesOffset = AppendAligned(out, view.batZones, view.batZoneCount * sizeof(Rectangle));
+        entry.tilesOffset = AppendAligned(out, view.tiles, view.platformCount);
+    }
+
+    LevelFileHeader header = {};
+    memcpy(header.magic, levelFileMagic, sizeof(levelFileMagic));
+    header.version = levelFileVersion;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.chunkWidth = LevelChunkWidth();
+    memcpy(out.data(), &header, sizeof(header));
+    if (!entries.empty()) memcpy(out.data() + sizeof(header), entries.data(), entries.size() * sizeof(LevelFileEntry));
+
+    // Written beside the target and renamed over it, so a running game that has
+    // the old file mapped never sees it half written
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (fclose(file) != 0 || !ok) return false;
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool SaveLevelsText(const std::string& path, const std::vector<Level>& levels) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "# findtreasure levels: level seed chunks width spawnX spawnY flagX flagY routeCount\n");
+    for (const Level& level : levels) {
+        fprintf(file, "level %llu %d %.9g %.9g %.9g %.9g %.9g %d\n", static_cast<unsigned long long>(level.seed),
+                level.chunkCount, level.width, level.playerSpawn.x, level.playerSpawn.y, level.flagPosition.x,
+                level.flagPosition.y, level.routeCount);
+        for (size_t i = 0; i < level.platforms.size(); i++) {
+            const Rectangle& r = level.platforms[i].rect;
+            uint8_t tile = i < level.tiles.size() && level.tiles[i] < TILE_KIND_COUNT ? level.tiles[i] : static_cast<uint8_t>(TILE_GROUND);
+            fprintf(file, "platform %.9g %.9g %.9g %.9g %s\n", r.x, r.y, r.width, r.height, tileNames[tile]);
+        }
+        for (const Rectangle& r : level.batZones) {
+            fprintf(file, "batzone %.9g %.9g %.9g %.9g\n", r.x, r.y, r.width, r.height);
+        }
+        fprintf(file, "end\n");
+    }
+    return fclose(file) == 0;
+}
+
+bool LoadLevelsText(const std::string& path, std::vector<Level>& levels) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path.c_str());
+        return false;
+    }
+    levels.clear();
+    char line[512];
+    int lineNumber = 0;
+    bool inLevel = false;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char keyword[16] = "";
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') continue;
+
+        if (strcmp(keyword, "level") == 0 && !inLevel) {
+            Level level = {};
+            unsigned long long seed;
+            ok = sscanf(line, "level %llu %d %f %f %f %f %f %d", &seed, &level.chunkCount, &level.width,
+                        &level.playerSpawn.x, &level.playerSpawn.y, &level.flagPosition.x, &level.flagPosition.y,
+                        &level.routeCount) == 8 && level.chunkCount > 0;
+            level.seed = seed;
+            levels.push_back(level);
+            inLevel = true;
+        } else if (strcmp(keyword, "platform") == 0 && inLevel) {
+            Rectangle r;
+            char tileName[16] = "ground";
+            int fields = sscanf(line, "platform %f %f %f %f %15s", &r.x, &r.y, &r.width, &r.height, tileName);
+            uint8_t tile = TILE_KIND_COUNT;
+            for (uint8_t t = 0; t < TILE_KIND_COUNT; t++) {
+                if (strcmp(tileName, tileNames[t]) == 0) tile = t;
+            }
+            ok = fields >= 4 && tile < TILE_KIND_COUNT;
+            levels.back().platforms.push_back({r});
+            levels.back().tiles.push_back(tile);
+        } else if (strcmp(keyword, "batzone") == 0 && inLevel) {
+            Rectangle r;
+            ok = sscanf(line, "batzone %f %f %f %f", &r.x, &r.y, &r.width, &r.height) == 4;
+            levels.back().batZones.push_back(r);
+        } else if (strcmp(keyword, "end") == 0 && inLevel) {
+            Level& level = levels.back();
+            ok = level.routeCount >= 0 && level.routeCount <= static_cast<int>(level.platforms.size());
+            inLevel = false;
+        } else {
+            ok = false;
+        }
+    }
+    fclose(file);
+    if (ok && inLevel) {
+        fprintf(stderr, "%s: missing \"end\" after the last level\n", path.c_str());
+        return false;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s:%d: syntax error\n", path.c_str(), lineNumber);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "level_generator.h"
+#include "mapped_file.h"
+#include <string>
+#include <vector>
+
+// Level sets on disk, in two formats:
+//
+// Text (hand-editable, what findtreasure_levelgen writes), one block per level:
+//   level <seed> <chunks> <width> <spawnX> <spawnY> <flagX> <flagY> <routeCount>
+//   platform <x> <y> <width> <height> [ground|ledge|stair]
+//   batzone <x> <y> <width> <height>
+//   end
+// Blank lines and lines starting with '#' are ignored.
+//
+// Binary (.ftlv, built by findtreasure_levelc): every level already baked, so
+// a memory-mapped file is used in place. GetLevelView only points into the
+// mapping; nothing is parsed or copied until InitWorld copies the arrays.
+
+// An open binary level file. Offsets were bounds-checked when it was opened.
+struct LevelFile {
+    MappedFile mapped;
+    int levelCount;
+};
+
+// Map path and check every level's arrays lie inside it; returns false (and
+// prints why) if it is not a valid level file for this build
+bool OpenLevelFile(LevelFile& file, const std::string& path);
+
+void CloseLevelFile(LevelFile& file);
+
+// Level index of an open file, pointing into the mapping (valid until CloseLevelFile)
+bool GetLevelView(const LevelFile& file, int index, LevelView& view);
+
+// Bake levels and write them as one binary file; returns false if it cannot be written
+bool SaveLevelFile(const std::string& path, const std::vector<Level>& levels);
+
+bool SaveLevelsText(const std::string& path, const std::vector<Level>& levels);
+
+// Parse a text level set into levels; returns false (and prints the file and line) on a syntax error
+bool LoadLevelsText(const std::string& path, std::vector<Level>& levels);
@@ -0,0 +1,244 @@
+#include "level_generator.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+// Ticks one scripted jump may take before it counts as failed
+const int jumpTestTicks = ticksPerSecond * 4;
+
+LevelSettings DefaultLevelSettings(int chunkCount) {
+    LevelSettings settings;
+    settings.chunkCount = std::max(1, chunkCount);
+    settings.playerSize = defaultPlayerSize;
+    settings.jumpSafety = 0.75f;
+    settings.minRunTiles = 4;
+    settings.maxRunTiles = 10;
+    settings.maxGroundLevel = 4;
+    settings.minStairs = 4;
+    settings.maxStairs = 8;
+    settings.floatingChance = 60;
+    settings.batZoneChance = 30;
+    settings.maxAttempts = 16;
+    settings.simulateRoute = false;
+    return settings;
+}
+
+static float GroundTop(int groundLevel) {
+    return static_cast<float>(screenHeight - groundLevel * tileSize);
+}
+
+// Solid ground groundLevel tiles high, from its top down to the bottom of the screen
+static Platform GroundRun(int column, int tiles, int groundLevel) {
+    return {{static_cast<float>(column * tileSize), GroundTop(groundLevel),
+             static_cast<float>(tiles * tileSize), static_cast<float>(groundLevel * tileSize)}};
+}
+
+// Floating platform and bat zone over a run, kept clear of its ends so they do
+// not get in the way of the jumps into and out of the run
+static void DecorateRun(Level& level, std::vector<Platform>& extras, Rng& rng, const LevelSettings& settings,
+                        int runStart, int runTiles, int groundLevel) {
+    if (runTiles >= 8 && RandomInt(rng, 0, 99) < settings.floatingChance) {
+        int width = std::min(RandomInt(rng, 2, 4), runTiles - 6);
+        int column = runStart + RandomInt(rng, 4, runTiles - 2 - width);
+        // High enough that the player can always walk underneath
+        float y = std::max(static_cast<float>(tileSize), GroundTop(groundLevel) - RandomInt(rng, 200, 300));
+        extras.push_back({{static_cast<float>(column * tileSize), y, static_cast<float>(width * tileSize),
+                           static_cast<float>(tileSize)}});
+    }
+    if (RandomInt(rng, 0, 99) < settings.batZoneChance) {
+        // Bats fly in the top third of the screen
+        level.batZones.push_back({static_cast<float>(runStart * tileSize), 0,
+                                  static_cast<float>(runTiles * tileSize), static_cast<float>(screenHeight / 3)});
+    }
+}
+
+// One candidate layout: runs of ground joined by gaps and height steps, then a
+// staircase to the flag. Gaps are sized from the measured jump, so most layouts
+// pass validation first time. plain leaves out everything but flat ground and
+// the stairs, which any player can climb.
+static void BuildLayout(Level& level, Rng& rng, const LevelSettings& settings, bool plain) {
+    level.platforms.clear();
+    level.batZones.clear();
+    std::vector<Platform> extras;
+
+    int columns = settings.chunkCount * worldChunkTiles;
+    int stairWidth = RandomInt(rng, 1, 2);
+    int stairs = RandomInt(rng, settings.minStairs, settings.maxStairs);
+    int finaleColumns = settings.maxStairs * 2 + 4; // Run-up, widest staircase and a spare tile
+
+    int groundLevel = 1;
+    int runStart = 0;
+    int runTiles = 8; // Flat start around the spawn point
+    while (!plain && runStart + runTiles + 4 + finaleColumns < columns) {
+        level.platforms.push_back(GroundRun(runStart, runTiles, groundLevel));
+        if (runStart > 0) DecorateRun(level, extras, rng, settings, runStart, runTiles, groundLevel);
+
+        // Next run: up to two tiles up or down, across a gap or straight up a step
+        int nextLevel = std::max(1, std::min(settings.maxGroundLevel, groundLevel + RandomInt(rng, -2, 2)));
+        int gap = 0;
+        if (RandomInt(rng, 0, 1) == 0 || nextLevel == groundLevel) {
+            float rise = static_cast<float>((nextLevel - groundLevel) * tileSize);
+            float reach = std::max(0.0f, JumpReach(GetJumpEnvelope(), rise));
+            int maxGap = static_cast<int>(reach * settings.jumpSafety / tileSize);
+            gap = std::max(1, RandomInt(rng, 1, std::max(1, maxGap)));
+        }
+        runStart += runTiles + gap;
+        groundLevel = nextLevel;
+        runTiles = RandomInt(rng, settings.minRunTiles, settings.maxRunTiles);
+    }
+
+    // Last run reaches the end of the level and carries the staircase; the top
+    // step stays two tiles below the top of the screen, leaving room for the flag
+    level.platforms.push_back(GroundRun(runStart, columns - runStart, groundLevel));
+    stairs = std::min(stairs, static_cast<int>(GroundTop(groundLevel) / tileSize) - 2);
+    int stairsStart = columns - 1 - stairs * stairWidth;
+    float top = GroundTop(groundLevel);
+    for (int i = 0; i < stairs; i++) {
+        level.platforms.push_back({{static_cast<float>((stairsStart + i * stairWidth) * tileSize),
+                                    top - (i + 1) * tileSize, static_cast<float>(stairWidth * tileSize),
+                                    static_cast<float>(tileSize)}});
+    }
+    const Rectangle& topStair = level.platforms.back().rect;
+    level.flagPosition = {topStair.x + topStair.width - 40, topStair.y - 60}; // Near the right edge of the top stair
+
+    level.routeCount = static_cast<int>(level.platforms.size());
+    level.tiles.assign(level.routeCount, TILE_GROUND);
+    std::fill(level.tiles.end() - stairs, level.tiles.end(), TILE_STAIR);
+    level.platforms.insert(level.platforms.end(), extras.begin(), extras.end());
+    level.tiles.resize(level.platforms.size(), TILE_LEDGE);
+    level.playerSpawn = {100, GroundTop(1)};
+}
+
+static bool Overlaps(const Rectangle& a, const Rectangle& b) {
+    return a.x < b.x + b.width && a.x + a.width > b.x && a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+// Held buttons for a scripted jump: first for firstTicks ticks, then rest
+struct JumpScript {
+    uint8_t first;
+    int firstTicks;
+    uint8_t rest;
+};
+
+static const JumpScript jumpScripts[] = {
+    {INPUT_RIGHT | INPUT_SPACE, 0, INPUT_RIGHT | INPUT_SPACE}, // Full running jump
+    {INPUT_RIGHT, 0, INPUT_RIGHT},                             // Walk off the edge
+    {INPUT_SPACE, 12, INPUT_RIGHT | INPUT_SPACE},              // Straight up, then right (up a wall)
+    {INPUT_RIGHT | INPUT_SPACE, 10, INPUT_SPACE},              // Short hop onto a narrow step
+};
+
+// Stand the player at x on route platform from, run the script through
+// StepPlayer and return the route platform it lands on, or -1
+static int TryJump(GameState& state, int routeCount, int from, float x, const JumpScript& script) {
+    Player& player = state.player;
+    const Rectangle& start = state.platforms[from].rect;
+    float width = player.bounds.width, height = player.bounds.height;
+    player.position = {x, start.y - height};
+    player.velocity = {0, 0};
+    player.isJumping = false;
+    player.bounds = {x, start.y - height, width, height};
+    player.coyoteTimer = coyoteTimeFrames;
+    player.jumpBufferTimer = 0;
+    player.jumpHoldTimer = 0;
+    player.isJumpHeld = false;
+    player.lastSafePosition = player.position;
+    state.previousButtons = 0;
+
+    // The take-off spot itself has to be free
+    QueryPlatformGrid(state.platformGrid, player.bounds, state.collisionCandidates);
+    for (int index : state.collisionCandidates) {
+        if (Overlaps(player.bounds, state.platforms[index].rect)) return -1;
+    }
+
+    bool airborne = false;
+    for (int t = 0; t < jumpTestTicks; t++) {
+        StepPlayer(state, {t < script.firstTicks ? script.first : script.rest});
+        if (player.position.y > screenHeight) return -1; // Fell out of the level
+        if (player.isJumping) {
+            airborne = true;
+            continue;
+        }
+        if (!airborne) continue; // Still walking along the take-off platform
+
+        // Landed; the vertical sweep's candidates include what the player stands on
+        float feet = player.position.y + height;
+        int landed = -1;
+        for (int index : state.collisionCandidates) {
+            const Rectangle& rect = state.platforms[index].rect;
+            if (index < routeCount && fabsf(rect.y - feet) <= collisionSkin && rect.x < player.position.x + width &&
+                player.position.x < rect.x + rect.width) {
+                landed = std::max(landed, index);
+            }
+        }
+        return landed;
+    }
+    return -1;
+}
+
+bool ValidateLevelRoute(LevelValidator& validator, const Level& level, Vector2 playerSize) {
+    if (level.routeCount <= 0) return false;
+    GameState& state = validator.state;
+    state.platforms.assign(level.platforms.begin(), level.platforms.end());
+    BuildPlatformGrid(state.platformGrid, state.platforms);
+    state.world.width = level.width;
+    state.player.speed = playerSpeed;
+    state.player.bounds = {0, 0, playerSize.x, playerSize.y};
+    state.player.isFacingRight = true;
+
+    std::vector<char>& reachable = validator.reachable;
+    reachable.assign(level.routeCount, 0);
+    reachable[0] = 1; // The spawn point is on the first run
+    for (int from = 0; from + 1 < level.routeCount; from++) {
+        if (!reachable[from]) continue;
+        const Rectangle& a = level.platforms[from].rect;
+        const Rectangle& b = level.platforms[from + 1].rect;
+        // From the end of the platform, and from against the next one's wall when it stands on this one
+        float takeOffs[2] = {a.x + a.width - playerSize.x, std::min(a.x + a.width, b.x) - playerSize.x};
+        for (int i = 0; i < 2 && !reachable[from + 1]; i++) {
+            if ((i == 1 && takeOffs[1] == takeOffs[0]) || takeOffs[i] + playerSize.x <= a.x) continue;
+            for (const JumpScript& script : jumpScripts) {
+                int landed = TryJump(state, level.routeCount, from, takeOffs[i], script);
+                if (landed > from) reachable[landed] = 1;
+                if (reachable[from + 1]) break;
+            }
+        }
+    }
+    return reachable[level.routeCount - 1] != 0;
+}
+
+// Solvability check for one layout; also records the shortest path length
+static bool CheckLevel(LevelValidator& validator, Level& level, const LevelSettings& settings) {
+    bool solvable = AnalyzeLevel(validator.analyzer, level.platforms, level.playerSpawn, level.flagPosition,
+                                 settings.playerSize, validator.analysis);
+    level.pathLength = static_cast<int>(validator.analysis.path.size());
+    if (solvable && settings.simulateRoute) solvable = ValidateLevelRoute(validator, level, settings.playerSize);
+    return solvable;
+}
+
+bool GenerateLevel(Level& level, uint64_t seed, const LevelSettings& settings, LevelValidator& validator) {
+    level.seed = seed;
+    level.chunkCount = settings.chunkCount;
+    level.width = static_cast<float>(settings.chunkCount * worldChunkTiles * tileSize);
+    Rng rng;
+    SeedRng(rng, seed);
+    for (int attempt = 1; attempt <= settings.maxAttempts; attempt++) {
+        level.attempts = attempt;
+        BuildLayout(level, rng, settings, false);
+        if (CheckLevel(validator, level, settings)) return true;
+    }
+    BuildLayout(level, rng, settings, true);
+    CheckLevel(validator, level, settings);
+    return false;
+}
+
+int GenerateLevels(std::vector<Level>& levels, uint64_t firstSeed, int count, const LevelSettings& settings,
+                   int threadCount) {
+    levels.resize(std::max(0, count));
+    std::atomic<int> failed(0);
+    ParallelFor(count, threadCount, [&](int i) {
+        static thread_local LevelValidator validator;
+        if (!GenerateLevel(levels[i], firstSeed + static_cast<uint64_t>(i), settings, validator)) failed++;
+    });
+    return failed.load();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "level_analyzer.h"
+#include <cstdint>
+#include <vector>
+
+// Player collision box the default sprites produce (200x157 at batScale)
+const Vector2 defaultPlayerSize = {37.5f, 29.4375f};
+
+// A whole generated level in world coordinates. The platforms the player must
+// cross to reach the flag come first, in the order they are crossed.
+struct Level {
+    uint64_t seed;
+    int chunkCount;                  // Width in world chunks
+    float width;
+    Vector2 playerSpawn;             // Where the player's feet start
+    Vector2 flagPosition;            // Top-left of the flag, on the last route platform
+    std::vector<Platform> platforms; // platforms[0, routeCount) are the route, the rest are extras
+    std::vector<uint8_t> tiles;      // TileKind per platform
+    int routeCount;
+    int pathLength;                  // Fewest platforms from spawn to flag (AnalyzeLevel)
+    std::vector<Rectangle> batZones; // Bats appear in these as the camera reaches them, left to right
+    int attempts;                    // Layouts generated before one passed validation
+};
+
+// Knobs for GenerateLevel; DefaultLevelSettings gives the game's values
+struct LevelSettings {
+    int chunkCount;
+    Vector2 playerSize;    // Collision box used when validating jumps
+    float jumpSafety;      // Fraction of the measured jump reach gaps may use
+    int minRunTiles;       // Length of flat ground between features
+    int maxRunTiles;
+    int maxGroundLevel;    // Ground height in tiles (1 = the original floor)
+    int minStairs;         // Steps in the staircase up to the flag
+    int maxStairs;
+    int floatingChance;    // Percent of long runs that get a floating platform
+    int batZoneChance;     // Percent of runs that get a bat zone
+    int maxAttempts;       // Re-rolls before GenerateLevel gives up
+    bool simulateRoute;    // Also check every level with ValidateLevelRoute (slower, stricter)
+};
+
+LevelSettings DefaultLevelSettings(int chunkCount);
+
+// Scratch memory for validation; keep one per thread and reuse it
+struct LevelValidator {
+    LevelAnalyzer analyzer;
+    LevelAnalysis analysis;
+    GameState state;  // For ValidateLevelRoute; only the player, platforms and grid are used
+    std::vector<char> reachable;
+};
+
+// Check with the real player physics (StepPlayer) that the flag can be reached
+// along the route: from every route platform known to be reachable, play a few
+// scripted jumps and walks and mark each later route platform they land on.
+// Unlike AnalyzeLevel this sees ceilings, but only tries the scripted moves.
+bool ValidateLevelRoute(LevelValidator& validator, const Level& level, Vector2 playerSize);
+
+// Deterministically build a level from seed. Each layout is checked with
+// AnalyzeLevel (and ValidateLevelRoute if settings.simulateRoute) and re-rolled
+// (up to maxAttempts) until one passes; returns false if none did, leaving a
+// plain fallback layout in level.
+bool GenerateLevel(Level& level, uint64_t seed, const LevelSettings& settings, LevelValidator& validator);
+
+// Generate count levels for seeds firstSeed, firstSeed + 1, ... across
+// threadCount threads (0 = all cores). Returns how many failed validation.
+int GenerateLevels(std::vector<Level>& levels, uint64_t firstSeed, int count, const LevelSettings& settings,
+                   int threadCount = 0);
@@ -0,0 +1,80 @@
+#include "level_sequence.h"
+#include <functional>
+
+// Read one byte per page, so a mapped level is paged in on the preload thread
+// instead of stalling the game thread when InitWorld copies it
+static void TouchPages(const void* data, size_t size) {
+    const volatile unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t offset = 0; offset < size; offset += 4096) {
+        (void)bytes[offset];
+    }
+}
+
+// Level index of the session (0 = the first) into sequence.next
+static void PreloadLevel(LevelSequence& sequence, int index) {
+    if (sequence.file) {
+        int count = sequence.file->levelCount;
+        GetLevelView(*sequence.file, (sequence.firstLevel + index) % count, sequence.next);
+        const LevelView& view = sequence.next;
+        TouchPages(view.platforms, view.platformCount * sizeof(Platform));
+        TouchPages(view.tiles, view.platformCount);
+        TouchPages(view.chunkStart, (view.chunkCount + 1) * sizeof(uint32_t));
+        TouchPages(view.batZones, view.batZoneCount * sizeof(Rectangle));
+    } else {
+        GenerateLevel(sequence.level, sequence.firstSeed + static_cast<uint64_t>(index), sequence.settings,
+                      sequence.validator);
+        BakeLevel(sequence.level, sequence.baked);
+        sequence.next = sequence.baked.view;
+    }
+}
+
+// Load the first level synchronously, then preload the second in the background
+static void StartSequence(LevelSequence& sequence, GameState& state) {
+    sequence.levelIndex = 0;
+    PreloadLevel(sequence, 0);
+    InitGame(state, sequence.next, sequence.playerSpriteSize, sequence.batFrameSize);
+    sequence.preloader = std::thread(PreloadLevel, std::ref(sequence), 1);
+}
+
+void BeginLevelSequence(LevelSequence& sequence, GameState& state, uint64_t firstSeed, Vector2 playerSpriteSize,
+                        Vector2 batFrameSize, int levelChunks) {
+    EndLevelSequence(sequence);
+    sequence.file = nullptr;
+    sequence.firstSeed = firstSeed;
+    sequence.firstLevel = 0;
+    sequence.playerSpriteSize = playerSpriteSize;
+    sequence.batFrameSize = batFrameSize;
+    // Same settings as InitGame, so the first level matches a game started from the seed
+    sequence.settings = DefaultLevelSettings(levelChunks);
+    sequence.settings.playerSize = {playerSpriteSize.x * batScale, playerSpriteSize.y * batScale};
+    StartSequence(sequence, state);
+}
+
+void BeginLevelSequence(LevelSequence& sequence, GameState& state, const LevelFile& file, int firstLevel,
+                        Vector2 playerSpriteSize, Vector2 batFrameSize) {
+    EndLevelSequence(sequence);
+    sequence.file = &file;
+    sequence.firstSeed = 0;
+    sequence.firstLevel = firstLevel;
+    sequence.playerSpriteSize = playerSpriteSize;
+    sequence.batFrameSize = batFrameSize;
+    StartSequence(sequence, state);
+}
+
+bool UpdateLevelSequence(LevelSequence& sequence, GameState& state) {
+    if (!LevelTransitionDue(state)) return false;
+
+    // Usually finished long ago; InitWorld copies the level, so the preload
+    // buffers are free again as soon as InitGame returns
+    sequence.preloader.join();
+    Score score = state.score;
+    InitGame(state, sequence.next, sequence.playerSpriteSize, sequence.batFrameSize);
+    state.score = score;
+    sequence.levelIndex++;
+    sequence.preloader = std::thread(PreloadLevel, std::ref(sequence), sequence.levelIndex + 1);
+    return true;
+}
+
+void EndLevelSequence(LevelSequence& sequence) {
+    if (sequence.preloader.joinable()) sequence.preloader.join();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "game.h"
+#include "level_file.h"
+#include <thread>
+
+// A session of levels played back to back. While one level is played the next
+// is generated (or, from a level file, paged in) on a background thread; once
+// the flag's transition is over it is swapped into the GameState with the
+// score carried over. Nothing outside the GameState is touched, so the window,
+// textures and music stay as they are.
+struct LevelSequence {
+    const LevelFile* file;     // Levels come from this file, or are generated from seeds if null
+    uint64_t firstSeed;        // Generated level i uses seed firstSeed + i
+    int firstLevel;            // File level played first; the rest follow in order and wrap around
+    int levelIndex;            // Levels finished this session (0 while playing the first)
+    Vector2 playerSpriteSize;
+    Vector2 batFrameSize;
+    LevelSettings settings;
+
+    // Only the preload thread touches these until it is joined
+    std::thread preloader;
+    LevelValidator validator;
+    Level level;
+    BakedLevel baked;
+    LevelView next;            // The preloaded level: into baked, or into the file's mapping
+};
+
+// Start a session of generated levels in state, beginning with the one
+// InitGame(state, firstSeed, ...) would build
+void BeginLevelSequence(LevelSequence& sequence, GameState& state, uint64_t firstSeed, Vector2 playerSpriteSize,
+                        Vector2 batFrameSize, int levelChunks = defaultLevelChunks);
+
+// Start a session of the levels in an open level file, beginning with firstLevel.
+// file must stay open until EndLevelSequence.
+void BeginLevelSequence(LevelSequence& sequence, GameState& state, const LevelFile& file, int firstLevel,
+                        Vector2 playerSpriteSize, Vector2 batFrameSize);
+
+// Call after every Step: once LevelTransitionDue, swaps the preloaded level in
+// and starts preloading the one after. Returns true if the level changed.
+bool UpdateLevelSequence(LevelSequence& sequence, GameState& state);
+
+// Wait for the preload thread; call before the sequence or its file goes away
+void EndLevelSequence(LevelSequence& sequence);
@@ -0,0 +1,67 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool OpenMappedFile(MappedFile& file, const std::string& path) {
+    file = {nullptr, 0, nullptr, nullptr};
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(handle);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+    file.data = static_cast<const unsigned char*>(view);
+    file.size = static_cast<size_t>(size.QuadPart);
+    file.handle = handle;
+    file.mapping = mapping;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED) return false;
+    file.data = static_cast<const unsigned char*>(view);
+    file.size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void CloseMappedFile(MappedFile& file) {
+    if (file.data == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(file.data);
+    CloseHandle(static_cast<HANDLE>(file.mapping));
+    CloseHandle(static_cast<HANDLE>(file.handle));
+#else
+    munmap(const_cast<unsigned char*>(file.data), file.size);
+#endif
+    file = {nullptr, 0, nullptr, nullptr};
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are loaded on first touch,
+// so opening is O(1) and data can be used in place without parsing or copying.
+struct MappedFile {
+    const unsigned char* data;
+    size_t size;
+    void* handle;   // Platform file/mapping handles (opaque)
+    void* mapping;
+};
+
+// Map path read-only; returns false (and leaves file empty) if it cannot be opened
+bool OpenMappedFile(MappedFile& file, const std::string& path);
+
+void CloseMappedFile(MappedFile& file);
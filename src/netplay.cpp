@@ -0,0 +1,164 @@
+#include "netplay.h"
+#include <algorithm>
+#include <cstring>
+
+// Packet layout (native byte order, like the level and asset files):
+//   magic "FTNP", simulationVersion, seed, sender player, sender tick,
+//   sender advantage, acknowledged tick, first input tick, input count, inputs
+static const char netMagic[4] = {'F', 'T', 'N', 'P'};
+static const int netHeaderSize = 4 + 4 + 8 + 1 + 8 + 1 + 8 + 8 + 1;
+static const int maxPacketInputs = rollbackInputRing;
+static_assert(netHeaderSize + maxPacketInputs <= static_cast<int>(sizeof(DelayedPacket::data)),
+              "A full packet must fit in DelayedPacket");
+
+struct NetPacket {
+    uint32_t version;
+    uint64_t seed;
+    uint8_t player;
+    int64_t tick;
+    int8_t advantage;
+    int64_t ack;
+    int64_t firstTick;
+    uint8_t count;
+    uint8_t inputs[maxPacketInputs];
+};
+
+template <typename T>
+static void Put(uint8_t*& out, T value) {
+    memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+template <typename T>
+static T Get(const uint8_t*& in) {
+    T value;
+    memcpy(&value, in, sizeof(value));
+    in += sizeof(value);
+    return value;
+}
+
+static int WriteNetPacket(const NetPacket& packet, uint8_t* data) {
+    uint8_t* out = data;
+    memcpy(out, netMagic, sizeof(netMagic));
+    out += sizeof(netMagic);
+    Put(out, packet.version);
+    Put(out, packet.seed);
+    Put(out, packet.player);
+    Put(out, packet.tick);
+    Put(out, packet.advantage);
+    Put(out, packet.ack);
+    Put(out, packet.firstTick);
+    Put(out, packet.count);
+    memcpy(out, packet.inputs, packet.count);
+    return static_cast<int>(out - data) + packet.count;
+}
+
+static bool ReadNetPacket(const uint8_t* data, int size, NetPacket& packet) {
+    if (size < netHeaderSize || memcmp(data, netMagic, sizeof(netMagic)) != 0) return false;
+    const uint8_t* in = data + sizeof(netMagic);
+    packet.version = Get<uint32_t>(in);
+    packet.seed = Get<uint64_t>(in);
+    packet.player = Get<uint8_t>(in);
+    packet.tick = Get<int64_t>(in);
+    packet.advantage = Get<int8_t>(in);
+    packet.ack = Get<int64_t>(in);
+    packet.firstTick = Get<int64_t>(in);
+    packet.count = Get<uint8_t>(in);
+    if (packet.count > maxPacketInputs || size < netHeaderSize + packet.count) return false;
+    memcpy(packet.inputs, in, packet.count);
+    return true;
+}
+
+bool OpenNetPeer(NetPeer& peer, uint16_t localPort, const UdpAddress& remote, const NetConditions& conditions,
+                 uint64_t seed) {
+    if (!OpenUdpSocket(peer.socket, localPort)) return false;
+    peer.remote = remote;
+    peer.conditions = conditions;
+    peer.seed = seed;
+    SeedRng(peer.lossRng, seed ^ localPort);
+    peer.delayed.clear();
+    peer.delayed.reserve(256); // Half a second of packets at 60 Hz and 500 ms latency
+    peer.connected = false;
+    peer.remoteTick = 0;
+    peer.remoteAdvantage = 0;
+    peer.packetsSent = peer.packetsReceived = peer.packetsDropped = 0;
+    return true;
+}
+
+void CloseNetPeer(NetPeer& peer) {
+    CloseUdpSocket(peer.socket);
+    peer.delayed.clear();
+}
+
+void PollNetPeer(NetPeer& peer, RollbackSession& session, double now) {
+    // Packets held back by the simulated latency go out once due
+    size_t kept = 0;
+    for (size_t i = 0; i < peer.delayed.size(); i++) {
+        if (peer.delayed[i].sendAt <= now) {
+            SendUdp(peer.socket, peer.remote, peer.delayed[i].data, peer.delayed[i].size);
+        } else {
+            peer.delayed[kept++] = peer.delayed[i];
+        }
+    }
+    peer.delayed.resize(kept);
+
+    uint8_t data[sizeof(DelayedPacket::data)];
+    UdpAddress from;
+    int size;
+    while ((size = ReceiveUdp(peer.socket, data, sizeof(data), from)) > 0) {
+        NetPacket packet;
+        // Ignore strangers, ourselves and peers set up for another match
+        if (!ReadNetPacket(data, size, packet) || packet.version != simulationVersion || packet.seed != peer.seed ||
+            packet.player != 1 - session.localPlayer) {
+            continue;
+        }
+        peer.packetsReceived++;
+        peer.connected = true;
+        if (packet.tick >= peer.remoteTick) {
+            peer.remoteTick = packet.tick;
+            peer.remoteAdvantage = packet.advantage;
+        }
+        AcknowledgeLocalInputs(session, packet.ack);
+        AddRemoteInputs(session, packet.firstTick, packet.inputs, packet.count);
+    }
+}
+
+void SendNetInputs(NetPeer& peer, const RollbackSession& session, double now) {
+    int64_t tick = static_cast<int64_t>(session.state.tick);
+    NetPacket packet;
+    packet.version = simulationVersion;
+    packet.seed = peer.seed;
+    packet.player = static_cast<uint8_t>(session.localPlayer);
+    packet.tick = tick;
+    packet.advantage = static_cast<int8_t>(std::max<int64_t>(-100, std::min<int64_t>(100, tick - peer.remoteTick)));
+    packet.ack = session.remoteConfirmed;
+    packet.firstTick = session.localAcked + 1;
+    packet.count = static_cast<uint8_t>(std::max<int64_t>(0, std::min<int64_t>(maxPacketInputs, tick - packet.firstTick)));
+    for (int i = 0; i < packet.count; i++) {
+        packet.inputs[i] = GetLocalInput(session, packet.firstTick + i);
+    }
+
+    DelayedPacket outgoing;
+    outgoing.size = WriteNetPacket(packet, outgoing.data);
+    peer.packetsSent++;
+    const NetConditions& conditions = peer.conditions;
+    if (conditions.loss > 0 && RandomInt(peer.lossRng, 0, 9999) < static_cast<int>(conditions.loss * 10000)) {
+        peer.packetsDropped++;
+        return;
+    }
+    int delayMs = conditions.latencyMs + (conditions.jitterMs > 0 ? RandomInt(peer.lossRng, 0, conditions.jitterMs) : 0);
+    if (delayMs <= 0) {
+        SendUdp(peer.socket, peer.remote, outgoing.data, outgoing.size);
+    } else {
+        outgoing.sendAt = now + delayMs / 1000.0;
+        peer.delayed.push_back(outgoing);
+    }
+}
+
+bool ShouldWaitForPeer(const NetPeer& peer, const RollbackSession& session) {
+    if (!peer.connected) return true;
+    // Both sides see the other's tick one trip late, so the latency cancels
+    // out of the difference between the two advantages
+    int64_t localAdvantage = static_cast<int64_t>(session.state.tick) - peer.remoteTick;
+    return localAdvantage - peer.remoteAdvantage >= 2;
+}
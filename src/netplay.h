@@ -0,0 +1,53 @@
+#pragma once
+
+#include "rollback.h"
+#include "udp_socket.h"
+#include <vector>
+
+// Fake network trouble applied to outgoing packets, for testing over loopback
+struct NetConditions {
+    int latencyMs;  // One-way delay added to every packet
+    int jitterMs;   // Plus up to this much more, at random (packets may arrive out of order)
+    float loss;     // Fraction of packets dropped, 0 to 1
+};
+
+// Sent NetConditions-delayed packet waiting for its time
+struct DelayedPacket {
+    double sendAt; // SimClockSeconds-style time, seconds
+    int size;
+    uint8_t data[128];
+};
+
+// One side of a versus match over UDP. Every packet carries all local input the
+// peer has not acknowledged yet (so a lost packet is covered by the next one),
+// the last remote tick received (the acknowledgement) and the sender's tick,
+// for keeping the two simulations in step.
+struct NetPeer {
+    UdpSocket socket;
+    UdpAddress remote;
+    NetConditions conditions;
+    uint64_t seed;               // Both sides must play the same level
+    Rng lossRng;                 // Drives the simulated loss and jitter
+    std::vector<DelayedPacket> delayed;
+    bool connected;              // A packet from the peer has arrived
+    int64_t remoteTick;          // Peer's tick in its latest packet
+    int remoteAdvantage;         // How far the peer was ahead of our input in its latest packet
+    int64_t packetsSent, packetsReceived, packetsDropped;
+};
+
+// Bind localPort and address packets to remote; false if the socket cannot be opened
+bool OpenNetPeer(NetPeer& peer, uint16_t localPort, const UdpAddress& remote, const NetConditions& conditions,
+                 uint64_t seed);
+
+void CloseNetPeer(NetPeer& peer);
+
+// Release delayed packets that are due and read every waiting packet into the
+// session. now is in seconds on any steady clock.
+void PollNetPeer(NetPeer& peer, RollbackSession& session, double now);
+
+// Send the local input the peer has not acknowledged (also before the first tick, as a hello)
+void SendNetInputs(NetPeer& peer, const RollbackSession& session, double now);
+
+// Whether to let this tick pass without simulating, because this side runs
+// ahead of the peer (by more than one tick, after discounting latency)
+bool ShouldWaitForPeer(const NetPeer& peer, const RollbackSession& session);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <functional>
+
+// Number of worker threads to use when the caller passes 0
+int DefaultThreadCount();
+
+// Run fn(i) for every i in [0, count) across threadCount threads (0 = all cores).
+// Work is handed out one index at a time, so uneven items balance themselves.
+// The calling thread takes part and the call returns when every item is done.
+void ParallelFor(int count, int threadCount, const std::function<void(int)>& fn);
@@ -0,0 +1,96 @@
+#include "platform_grid.h"
+#include "game.h"
+#include <algorithm>
+#include <cmath>
+
+// Inclusive cell range covered by [minPos, maxPos] along one axis, clamped to the grid
+static void CellSpan(float minPos, float maxPos, float origin, float cellSize, int count, int& first, int& last) {
+    first = static_cast<int>(std::floor((minPos - origin) / cellSize));
+    last = static_cast<int>(std::floor((maxPos - origin) / cellSize));
+    first = std::max(first, 0);
+    last = std::min(last, count - 1);
+}
+
+void BuildPlatformGrid(PlatformGrid& grid, const std::vector<Platform>& platforms, float cellSize) {
+    grid.cellSize = (cellSize > 0.0f) ? cellSize : static_cast<float>(tileSize);
+    grid.cellStart.clear();
+    grid.cellItems.clear();
+    grid.stamp.assign(platforms.size(), 0);
+    grid.queryId = 0;
+
+    if (platforms.empty()) {
+        grid.originX = grid.originY = 0.0f;
+        grid.columns = grid.rows = 0;
+        grid.cellStart.push_back(0);
+        return;
+    }
+
+    // Level extents, snapped to the cell size so tiles land in exactly one cell
+    float minX = platforms[0].rect.x, minY = platforms[0].rect.y;
+    float maxX = minX + platforms[0].rect.width, maxY = minY + platforms[0].rect.height;
+    for (const auto& platform : platforms) {
+        minX = std::min(minX, platform.rect.x);
+        minY = std::min(minY, platform.rect.y);
+        maxX = std::max(maxX, platform.rect.x + platform.rect.width);
+        maxY = std::max(maxY, platform.rect.y + platform.rect.height);
+    }
+    grid.originX = std::floor(minX / grid.cellSize) * grid.cellSize;
+    grid.originY = std::floor(minY / grid.cellSize) * grid.cellSize;
+    grid.columns = static_cast<int>(std::floor((maxX - grid.originX) / grid.cellSize)) + 1;
+    grid.rows = static_cast<int>(std::floor((maxY - grid.originY) / grid.cellSize)) + 1;
+
+    // Two passes: count per cell, then scatter indices into their slots
+    size_t cellCount = static_cast<size_t>(grid.columns) * grid.rows;
+    grid.cellStart.assign(cellCount + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<int> cursor;
+        if (pass == 1) {
+            for (size_t c = 0; c < cellCount; c++) grid.cellStart[c + 1] += grid.cellStart[c];
+            grid.cellItems.resize(grid.cellStart[cellCount]);
+            cursor.assign(grid.cellStart.begin(), grid.cellStart.end() - 1);
+        }
+        for (size_t i = 0; i < platforms.size(); i++) {
+            const Rectangle& r = platforms[i].rect;
+            int x0, x1, y0, y1;
+            // Right/bottom edges are exclusive, so a 64px tile at x=64 only covers column 1
+            CellSpan(r.x, r.x + r.width - 0.001f, grid.originX, grid.cellSize, grid.columns, x0, x1);
+            CellSpan(r.y, r.y + r.height - 0.001f, grid.originY, grid.cellSize, grid.rows, y0, y1);
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    size_t cell = static_cast<size_t>(y) * grid.columns + x;
+                    if (pass == 0) grid.cellStart[cell + 1]++;
+                    else grid.cellItems[cursor[cell]++] = static_cast<int>(i);
+                }
+            }
+        }
+    }
+}
+
+void QueryPlatformGrid(PlatformGrid& grid, Rectangle area, std::vector<int>& out) {
+    out.clear();
+    if (grid.columns == 0) return;
+
+    int x0, x1, y0, y1;
+    CellSpan(area.x, area.x + area.width, grid.originX, grid.cellSize, grid.columns, x0, x1);
+    CellSpan(area.y, area.y + area.height, grid.originY, grid.cellSize, grid.rows, y0, y1);
+    if (x0 > x1 || y0 > y1) return;
+
+    // Wide platforms span several cells; the stamp keeps each index unique per query
+    if (++grid.queryId == 0) {
+        std::fill(grid.stamp.begin(), grid.stamp.end(), 0);
+        grid.queryId = 1;
+    }
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            size_t cell = static_cast<size_t>(y) * grid.columns + x;
+            for (int k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; k++) {
+                int index = grid.cellItems[k];
+                if (grid.stamp[index] != grid.queryId) {
+                    grid.stamp[index] = grid.queryId;
+                    out.push_back(index);
+                }
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "raylib.h" // Rectangle
+#include <cstdint>
+#include <vector>
+
+struct Platform;
+
+// Tile-aligned uniform grid over the level's platforms. Built once after level
+// generation; each cell lists the platforms whose rect touches it, stored
+// compactly (CSR layout: cellStart offsets into one cellItems array).
+struct PlatformGrid {
+    float originX;               // World position of cell (0, 0)
+    float originY;
+    float cellSize;
+    int columns;
+    int rows;
+    std::vector<int> cellStart;  // columns * rows + 1 offsets into cellItems
+    std::vector<int> cellItems;  // Platform indices, grouped by cell
+    std::vector<uint32_t> stamp; // Per platform: last query that returned it (dedupe)
+    uint32_t queryId;
+};
+
+// Rebuild the grid for the given platforms (cell size defaults to tileSize)
+void BuildPlatformGrid(PlatformGrid& grid, const std::vector<Platform>& platforms, float cellSize = 0.0f);
+
+// Write the indices of platforms whose cells overlap area into out, in ascending
+// index order so callers resolve in the same order as a linear scan would.
+void QueryPlatformGrid(PlatformGrid& grid, Rectangle area, std::vector<int>& out);
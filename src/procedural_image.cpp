@@ -0,0 +1,96 @@
+#include "procedural_image.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PROCEDURAL_IMAGE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static uint32_t PackColor(Color color) {
+    uint32_t pixel;
+    unsigned char bytes[4] = {color.r, color.g, color.b, color.a};
+    memcpy(&pixel, bytes, sizeof(pixel));
+    return pixel;
+}
+
+// Uninitialized RGBA8 image from raylib's allocator, so UnloadImage can free it
+static Image AllocImage(int width, int height) {
+    Image image = {};
+    image.data = MemAlloc(static_cast<unsigned int>(width) * height * 4);
+    image.width = width;
+    image.height = height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return image;
+}
+
+// Write pixel into count consecutive RGBA8 pixels
+static void FillRow(uint32_t* row, int count, uint32_t pixel) {
+    int x = 0;
+#ifdef PROCEDURAL_IMAGE_SSE2
+    const __m128i quad = _mm_set1_epi32(static_cast<int>(pixel));
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), quad);
+    }
+#endif
+    for (; x < count; x++) {
+        row[x] = pixel;
+    }
+}
+
+Image GenImageSolid(int width, int height, Color color) {
+    Image image = AllocImage(width, height);
+    uint32_t* pixels = static_cast<uint32_t*>(image.data);
+    // Fill the first row, then copy it down
+    FillRow(pixels, width, PackColor(color));
+    for (int y = 1; y < height; y++) {
+        memcpy(pixels + static_cast<size_t>(y) * width, pixels, static_cast<size_t>(width) * 4);
+    }
+    return image;
+}
+
+Image GenImageVerticalGradient(int width, int height, Color top, Color bottom) {
+    Image image = AllocImage(width, height);
+    uint32_t* pixels = static_cast<uint32_t*>(image.data);
+    for (int y = 0; y < height; y++) {
+        float factor = static_cast<float>(y) / height;
+        Color color = {
+            static_cast<unsigned char>(top.r + (bottom.r - top.r) * factor),
+            static_cast<unsigned char>(top.g + (bottom.g - top.g) * factor),
+            static_cast<unsigned char>(top.b + (bottom.b - top.b) * factor),
+            static_cast<unsigned char>(top.a + (bottom.a - top.a) * factor)
+        };
+        FillRow(pixels + static_cast<size_t>(y) * width, width, PackColor(color));
+    }
+    return image;
+}
+
+Image GenImageCheckerboard(int width, int height, int cellSize, Color first, Color second) {
+    Image image = AllocImage(width, height);
+    uint32_t* pixels = static_cast<uint32_t*>(image.data);
+    if (cellSize <= 0) cellSize = 1;
+    uint32_t a = PackColor(first), b = PackColor(second);
+
+    // Only two distinct rows exist; build them once and copy them down
+    for (int row = 0; row < 2 && row * cellSize < height; row++) {
+        uint32_t* dst = pixels + static_cast<size_t>(row) * cellSize * width;
+        for (int x = 0; x < width; x += cellSize) {
+            int span = (x + cellSize <= width) ? cellSize : width - x;
+            bool useFirst = ((x / cellSize) + row) % 2 == 0;
+            FillRow(dst + x, span, useFirst ? a : b);
+        }
+    }
+    for (int y = 1; y < height; y++) {
+        int band = (y / cellSize) % 2;
+        if (y == band * cellSize) continue; // One of the two template rows
+        memcpy(pixels + static_cast<size_t>(y) * width, pixels + static_cast<size_t>(band) * cellSize * width,
+               static_cast<size_t>(width) * 4);
+    }
+    return image;
+}
+
+bool SamePlaceholder(PlaceholderKey a, PlaceholderKey b) {
+    return a.width == b.width && a.height == b.height &&
+           a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b && a.color.a == b.color.a;
+}
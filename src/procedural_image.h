@@ -0,0 +1,26 @@
+#pragma once
+
+#include "raylib.h"
+
+// RGBA8 images generated by writing whole rows into the pixel buffer (16 bytes
+// per store with SSE2) instead of one ImageDrawPixel call per pixel. The
+// results are ordinary raylib Images: release them with UnloadImage.
+
+// Solid fill
+Image GenImageSolid(int width, int height, Color color);
+
+// Vertical gradient from top to bottom (same per-row blend as the old manual loop)
+Image GenImageVerticalGradient(int width, int height, Color top, Color bottom);
+
+// Checkerboard of cellSize squares, starting with first in the top-left corner
+Image GenImageCheckerboard(int width, int height, int cellSize, Color first, Color second);
+
+// Size and color of a generated placeholder; equal keys produce identical images,
+// so callers can generate (and upload) one image per key and share it
+struct PlaceholderKey {
+    int width;
+    int height;
+    Color color;
+};
+
+bool SamePlaceholder(PlaceholderKey a, PlaceholderKey b);
@@ -0,0 +1,118 @@
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// One zone entry for the Chrome trace
+struct TraceEvent {
+    int64_t start;    // Nanoseconds
+    int64_t duration;
+    uint8_t zone;
+};
+
+const int traceEventCapacity = 1 << 16; // ~10 s of frames at a dozen zones per frame
+
+struct Profiler {
+    bool enabled = false;
+    int64_t frameStart = -1;                                         // -1 outside a frame
+    int64_t frameTotals[PROFILE_ZONE_COUNT] = {};                    // Nanoseconds this frame
+    float history[PROFILE_ZONE_COUNT][profilerHistoryFrames] = {};   // Milliseconds per frame
+    int historyHead = 0;
+    int historyCount = 0;
+    TraceEvent events[traceEventCapacity] = {};
+    int eventHead = 0;
+    int eventCount = 0;
+};
+
+static Profiler profiler;
+
+static const char* zoneNames[PROFILE_ZONE_COUNT] = {
+    "frame", "input", "simulation", "physics", "collision", "bats", "audio",
+    "draw world", "draw sprites", "draw hud", "present"
+};
+
+// Set on the thread that owns the profiler, so other threads never touch it
+static thread_local bool profilerThread = false;
+
+void SetProfilerEnabled(bool enabled) {
+    profilerThread = true;
+    profiler.enabled = enabled;
+    profiler.frameStart = -1;
+}
+
+bool IsProfilerEnabled() {
+    return profilerThread && profiler.enabled;
+}
+
+const char* GetProfileZoneName(ProfileZone zone) {
+    return zoneNames[zone];
+}
+
+int64_t ProfilerNowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RecordProfileZone(ProfileZone zone, int64_t startNanoseconds, int64_t endNanoseconds) {
+    int64_t duration = endNanoseconds - startNanoseconds;
+    profiler.frameTotals[zone] += duration;
+
+    profiler.events[profiler.eventHead] = {startNanoseconds, duration, static_cast<uint8_t>(zone)};
+    profiler.eventHead = (profiler.eventHead + 1) % traceEventCapacity;
+    if (profiler.eventCount < traceEventCapacity) profiler.eventCount++;
+}
+
+void BeginProfilerFrame() {
+    if (!profiler.enabled) return;
+    std::fill(profiler.frameTotals, profiler.frameTotals + PROFILE_ZONE_COUNT, 0);
+    profiler.frameStart = ProfilerNowNanoseconds();
+}
+
+void EndProfilerFrame() {
+    if (!profiler.enabled || profiler.frameStart < 0) return;
+    RecordProfileZone(PROFILE_FRAME, profiler.frameStart, ProfilerNowNanoseconds());
+    profiler.frameStart = -1;
+
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        profiler.history[zone][profiler.historyHead] = profiler.frameTotals[zone] / 1e6f;
+    }
+    profiler.historyHead = (profiler.historyHead + 1) % profilerHistoryFrames;
+    if (profiler.historyCount < profilerHistoryFrames) profiler.historyCount++;
+}
+
+ProfileZoneStats GetProfileZoneStats(ProfileZone zone) {
+    ProfileZoneStats stats = {0, 0, 0, 0};
+    int count = profiler.historyCount;
+    if (count == 0) return stats;
+
+    float sorted[profilerHistoryFrames];
+    std::copy(profiler.history[zone], profiler.history[zone] + count, sorted);
+    std::sort(sorted, sorted + count);
+    int lastIndex = (profiler.historyHead + profilerHistoryFrames - 1) % profilerHistoryFrames;
+    stats.last = profiler.history[zone][lastIndex];
+    stats.p50 = sorted[(count - 1) / 2];
+    stats.p99 = sorted[(count - 1) * 99 / 100];
+    stats.max = sorted[count - 1];
+    return stats;
+}
+
+bool WriteChromeTrace(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    // Oldest event first; timestamps relative to the earliest start keep the numbers short
+    int first = (profiler.eventHead - profiler.eventCount + traceEventCapacity) % traceEventCapacity;
+    int64_t origin = profiler.eventCount > 0 ? profiler.events[first].start : 0;
+    for (int i = 0; i < profiler.eventCount; i++) {
+        origin = std::min(origin, profiler.events[(first + i) % traceEventCapacity].start);
+    }
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (int i = 0; i < profiler.eventCount; i++) {
+        const TraceEvent& event = profiler.events[(first + i) % traceEventCapacity];
+        // Chrome trace times are microseconds
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}", i ? ",\n" : "",
+                zoneNames[event.zone], (event.start - origin) / 1000.0, event.duration / 1000.0);
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(file) == 0;
+}
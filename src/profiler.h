@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Lightweight frame profiler. Code marks hot paths with PROFILE_SCOPE(zone);
+// each frame the time spent per zone is summed and kept for the last
+// profilerHistoryFrames frames (for p50/p99/max), and every individual zone
+// entry is kept in a ring buffer that can be written as a Chrome trace
+// (chrome://tracing or https://ui.perfetto.dev).
+//
+// Recording is off until SetProfilerEnabled(true), so headless tools and
+// benchmarks pay one branch per zone. Build with -DFINDTREASURE_PROFILER=OFF to
+// compile the zones out entirely. Only the thread that calls SetProfilerEnabled
+// records; zones entered on any other thread (the simulation thread, bot
+// workers) are ignored.
+
+enum ProfileZone {
+    PROFILE_FRAME,        // Whole frame, BeginProfilerFrame to EndProfilerFrame
+    PROFILE_INPUT,        // Keyboard sampling
+    PROFILE_SIMULATION,   // Step calls on the simulation thread, recorded when their snapshot is taken
+    PROFILE_PHYSICS,      // Player movement (only when Step runs on the profiled thread)
+    PROFILE_COLLISION,    // Player vs platforms (same)
+    PROFILE_BATS,         // Bat swarm update and hits (same)
+    PROFILE_AUDIO,        // Sound effect triggers (music streams on the audio thread)
+    PROFILE_DRAW_WORLD,   // Background, tilemap, flag
+    PROFILE_DRAW_SPRITES, // Player and bats
+    PROFILE_DRAW_HUD,     // Text and overlays
+    PROFILE_PRESENT,      // EndDrawing (batch flush, swap, frame cap wait)
+    PROFILE_ZONE_COUNT
+};
+
+const int profilerHistoryFrames = 240; // Four seconds at 60 FPS
+
+// Milliseconds per frame for one zone over the history window
+struct ProfileZoneStats {
+    float last;
+    float p50;
+    float p99;
+    float max;
+};
+
+void SetProfilerEnabled(bool enabled);
+bool IsProfilerEnabled();
+
+const char* GetProfileZoneName(ProfileZone zone);
+
+void BeginProfilerFrame();
+void EndProfilerFrame();
+
+ProfileZoneStats GetProfileZoneStats(ProfileZone zone);
+
+// Write the recorded zone entries (most recent ones, up to the ring size) as
+// Chrome trace JSON; returns false if the file cannot be written
+bool WriteChromeTrace(const std::string& path);
+
+// Nanoseconds on a monotonic clock
+int64_t ProfilerNowNanoseconds();
+
+void RecordProfileZone(ProfileZone zone, int64_t startNanoseconds, int64_t endNanoseconds);
+
+// For zones that do not match a C++ block: pass BeginProfileZone's result to
+// EndProfileZone (both are no-ops while the profiler is disabled)
+inline int64_t BeginProfileZone() {
+    return IsProfilerEnabled() ? ProfilerNowNanoseconds() : -1;
+}
+
+inline void EndProfileZone(ProfileZone zone, int64_t start) {
+    if (start >= 0) RecordProfileZone(zone, start, ProfilerNowNanoseconds());
+}
+
+// Times the enclosing block
+struct ProfileScope {
+    ProfileZone zone;
+    int64_t start;
+
+    explicit ProfileScope(ProfileZone scopeZone) : zone(scopeZone), start(BeginProfileZone()) {}
+    ~ProfileScope() { EndProfileZone(zone, start); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#ifdef FINDTREASURE_PROFILER
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
+#else
+#define PROFILE_SCOPE(zone) ((void)0)
+#endif
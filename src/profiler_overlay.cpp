@@ -0,0 +1,42 @@
+#include "profiler_overlay.h"
+#include "profiler.h"
+#include "raylib.h"
+#include <cstdio>
+
+static const float frameBudgetMs = 1000.0f / 60.0f;
+
+void DrawProfilerOverlay(int x, int y) {
+    const int rowHeight = 18, fontSize = 16;
+    const int barX = x + 400, barWidth = 160;
+    const int width = barX - x + barWidth + 10;
+    const int height = (PROFILE_ZONE_COUNT + 2) * rowHeight + 10;
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+
+    // The default font is proportional, so each column gets a fixed x
+    const int columnX[5] = {x + 5, x + 140, x + 205, x + 270, x + 335};
+    const char* headers[5] = {"zone (ms)", "last", "p50", "p99", "max"};
+    for (int column = 0; column < 5; column++) {
+        DrawText(headers[column], columnX[column], y + 5, fontSize, LIGHTGRAY);
+    }
+
+    char value[16];
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        ProfileZoneStats stats = GetProfileZoneStats(static_cast<ProfileZone>(zone));
+        int rowY = y + 5 + (zone + 1) * rowHeight;
+        Color color = stats.p99 > frameBudgetMs ? RED : (stats.p99 > frameBudgetMs * 0.5f ? YELLOW : WHITE);
+        DrawText(GetProfileZoneName(static_cast<ProfileZone>(zone)), columnX[0], rowY, fontSize, color);
+        float values[4] = {stats.last, stats.p50, stats.p99, stats.max};
+        for (int column = 0; column < 4; column++) {
+            snprintf(value, sizeof(value), "%.3f", values[column]);
+            DrawText(value, columnX[column + 1], rowY, fontSize, color);
+        }
+
+        // p50 solid, p99 outlined; the full bar is one 16.6 ms frame
+        float p50 = stats.p50 / frameBudgetMs, p99 = stats.p99 / frameBudgetMs;
+        DrawRectangle(barX, rowY + 3, static_cast<int>(barWidth * (p50 < 1 ? p50 : 1)), rowHeight - 6, color);
+        DrawRectangleLines(barX, rowY + 3, static_cast<int>(barWidth * (p99 < 1 ? p99 : 1)), rowHeight - 6, color);
+    }
+
+    DrawText("F3: hide profiler | F4: save profile_trace.json", x + 5, y + 5 + (PROFILE_ZONE_COUNT + 1) * rowHeight,
+             fontSize, LIGHTGRAY);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Table of per-zone frame times (last, p50, p99, max over the profiler history)
+// with a bar per zone scaled to the 60 FPS frame budget. Drawn with raylib, so
+// call it between BeginDrawing and EndDrawing.
+void DrawProfilerOverlay(int x, int y);
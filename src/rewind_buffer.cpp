@@ -0,0 +1,264 @@
+#include "rewind_buffer.h"
+#include <cstring>
+
+RewindSettings DefaultRewindSettings() {
+    RewindSettings settings;
+    settings.byteBudget = 512 * 1024;
+    settings.maxFrames = 45 * ticksPerSecond;
+    settings.keyframeInterval = ticksPerSecond / 2;
+    return settings;
+}
+
+// Record layout (native byte order): the GameState fields Step writes, bats last
+static const size_t rewindRecordFixedSize =
+    sizeof(Player) + sizeof(Flag) + sizeof(Score) + sizeof(float) + 2 * sizeof(int) + sizeof(bool) +
+    sizeof(uint8_t) + sizeof(uint64_t) + sizeof(Rng) + sizeof(int);
+static const size_t rewindBytesPerBat = 4 * sizeof(float) + 3 * sizeof(int32_t);
+
+static size_t RewindRecordSize(int batCount) {
+    return rewindRecordFixedSize + batCount * rewindBytesPerBat;
+}
+
+template <typename T>
+static void Put(uint8_t*& out, const T& value) {
+    memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+template <typename T>
+static void Get(const uint8_t*& in, T& value) {
+    memcpy(&value, in, sizeof(value));
+    in += sizeof(value);
+}
+
+template <typename T>
+static void PutArray(uint8_t*& out, const std::vector<T>& values, int count) {
+    memcpy(out, values.data(), count * sizeof(T));
+    out += count * sizeof(T);
+}
+
+template <typename T>
+static void GetArray(const uint8_t*& in, std::vector<T>& values, int count) {
+    values.resize(count); // Within the capacity the level already grew them to
+    memcpy(values.data(), in, count * sizeof(T));
+    in += count * sizeof(T);
+}
+
+// Whole structs are copied, padding included; padding rarely changes between
+// ticks, so it costs next to nothing in a delta
+static size_t WriteRewindRecord(const GameState& state, uint8_t* data) {
+    uint8_t* out = data;
+    Put(out, state.player);
+    Put(out, state.flag);
+    Put(out, state.score);
+    Put(out, state.cameraX);
+    Put(out, state.nextBatZone);
+    Put(out, state.transitionTimer);
+    Put(out, state.levelComplete);
+    Put(out, state.previousButtons);
+    Put(out, state.tick);
+    Put(out, state.rng);
+    const BatSwarm& bats = state.bats;
+    Put(out, bats.count);
+    PutArray(out, bats.positionX, bats.count);
+    PutArray(out, bats.positionY, bats.count);
+    PutArray(out, bats.velocityX, bats.count);
+    PutArray(out, bats.velocityY, bats.count);
+    PutArray(out, bats.respawnTimer, bats.count);
+    PutArray(out, bats.frameCounter, bats.count);
+    PutArray(out, bats.currentFrame, bats.count);
+    return out - data;
+}
+
+static void ReadRewindRecord(const uint8_t* data, GameState& state) {
+    const uint8_t* in = data;
+    Get(in, state.player);
+    Get(in, state.flag);
+    Get(in, state.score);
+    Get(in, state.cameraX);
+    Get(in, state.nextBatZone);
+    Get(in, state.transitionTimer);
+    Get(in, state.levelComplete);
+    Get(in, state.previousButtons);
+    Get(in, state.tick);
+    Get(in, state.rng);
+    BatSwarm& bats = state.bats;
+    Get(in, bats.count);
+    GetArray(in, bats.positionX, bats.count);
+    GetArray(in, bats.positionY, bats.count);
+    GetArray(in, bats.velocityX, bats.count);
+    GetArray(in, bats.velocityY, bats.count);
+    GetArray(in, bats.respawnTimer, bats.count);
+    GetArray(in, bats.frameCounter, bats.count);
+    GetArray(in, bats.currentFrame, bats.count);
+}
+
+// raw XOR key as tokens of (zero bytes to skip, literal count, literal bytes).
+// Zero runs shorter than a token's two bytes stay in the literals, and
+// trailing zeros are left out. Returns size, or a value >= size when the delta
+// would be no smaller than the record.
+static size_t EncodeRewindDelta(const uint8_t* raw, const uint8_t* key, size_t size, uint8_t* out) {
+    size_t i = 0, written = 0;
+    while (i < size) {
+        size_t zeros = 0;
+        while (i < size && zeros < 255 && raw[i] == key[i]) {
+            zeros++;
+            i++;
+        }
+        if (i == size) break;
+        size_t start = i, literals = 0;
+        while (i < size && literals < 255 &&
+               (raw[i] != key[i] || (i + 1 < size && raw[i + 1] != key[i + 1]) ||
+                (i + 2 < size && raw[i + 2] != key[i + 2]))) {
+            literals++;
+            i++;
+        }
+        if (written + 2 + literals >= size) return size;
+        out[written++] = static_cast<uint8_t>(zeros);
+        out[written++] = static_cast<uint8_t>(literals);
+        for (size_t j = start; j < start + literals; j++) {
+            out[written++] = raw[j] ^ key[j];
+        }
+    }
+    return written;
+}
+
+static void DecodeRewindDelta(const uint8_t* delta, size_t size, uint8_t* raw) {
+    size_t read = 0, position = 0;
+    while (read < size) {
+        position += delta[read++];
+        size_t literals = delta[read++];
+        for (size_t j = 0; j < literals; j++) {
+            raw[position++] ^= delta[read++];
+        }
+    }
+}
+
+static RewindFrame& FrameAt(RewindBuffer& buffer, int age) {
+    return buffer.frames[(buffer.firstFrame + age) % buffer.settings.maxFrames];
+}
+
+// Drop the oldest keyframe and its deltas, so the oldest left is a keyframe again
+static void DropOldestKeyframe(RewindBuffer& buffer) {
+    do {
+        buffer.firstFrame = (buffer.firstFrame + 1) % buffer.settings.maxFrames;
+        buffer.frameCount--;
+    } while (buffer.frameCount > 0 && !FrameAt(buffer, 0).keyframe);
+    if (buffer.frameCount == 0) ClearRewindBuffer(buffer);
+}
+
+// Offset where size bytes fit, dropping the oldest ticks until they do. The
+// records in use run from the oldest one's offset to writeOffset, wrapping
+// around the end of the ring.
+static uint32_t MakeRewindRoom(RewindBuffer& buffer, size_t size) {
+    const size_t capacity = buffer.bytes.size();
+    while (buffer.frameCount > 0) {
+        if (buffer.frameCount < buffer.settings.maxFrames) {
+            size_t head = FrameAt(buffer, 0).offset, tail = buffer.writeOffset;
+            if (tail > head) {
+                if (tail + size <= capacity) return static_cast<uint32_t>(tail);
+                if (size <= head) return 0;
+            } else if (tail + size <= head) {
+                return static_cast<uint32_t>(tail);
+            }
+        }
+        DropOldestKeyframe(buffer);
+    }
+    return 0;
+}
+
+void InitRewindBuffer(RewindBuffer& buffer, const RewindSettings& settings) {
+    buffer.settings = settings;
+    buffer.bytes.assign(settings.byteBudget, 0);
+    buffer.frames.assign(settings.maxFrames, RewindFrame{});
+    size_t recordSize = RewindRecordSize(maxBats);
+    buffer.raw.assign(recordSize, 0);
+    buffer.encoded.assign(recordSize, 0);
+    buffer.recordedBytes = 0;
+    buffer.recordedFrames = 0;
+    buffer.keyframes = 0;
+    ClearRewindBuffer(buffer);
+}
+
+void ClearRewindBuffer(RewindBuffer& buffer) {
+    buffer.firstFrame = 0;
+    buffer.frameCount = 0;
+    buffer.writeOffset = 0;
+}
+
+void RecordRewindFrame(RewindBuffer& buffer, const GameState& state) {
+    size_t rawSize = RewindRecordSize(state.bats.count);
+    if (rawSize > buffer.raw.size()) {
+        // More bats than maxBats; only happens if the level rules change
+        buffer.raw.resize(rawSize);
+        buffer.encoded.resize(rawSize);
+    }
+    WriteRewindRecord(state, buffer.raw.data());
+
+    // A delta against the newest keyframe, unless a new keyframe is due or it would not be smaller
+    size_t size = rawSize;
+    RewindFrame frame = {};
+    frame.rawSize = static_cast<uint16_t>(rawSize);
+    frame.keyframe = true;
+    if (buffer.frameCount > 0) {
+        const RewindFrame& newest = FrameAt(buffer, buffer.frameCount - 1);
+        if (newest.rawSize == rawSize && newest.keyDistance + 1 < buffer.settings.keyframeInterval) {
+            size = EncodeRewindDelta(buffer.raw.data(), buffer.bytes.data() + newest.keyOffset, rawSize,
+                                     buffer.encoded.data());
+            if (size < rawSize) {
+                frame.keyframe = false;
+                frame.keyOffset = newest.keyOffset;
+                frame.keyDistance = static_cast<uint16_t>(newest.keyDistance + 1);
+            } else {
+                size = rawSize;
+            }
+        }
+    }
+
+    frame.offset = MakeRewindRoom(buffer, size);
+    if (!frame.keyframe && buffer.frameCount == 0) {
+        // Making room dropped the keyframe the delta was against
+        frame.keyframe = true;
+        size = rawSize;
+        frame.offset = MakeRewindRoom(buffer, size);
+    }
+    if (frame.keyframe) {
+        frame.keyOffset = frame.offset;
+        frame.keyDistance = 0;
+        buffer.keyframes++;
+    }
+    frame.size = static_cast<uint32_t>(size);
+    const uint8_t* source = frame.keyframe ? buffer.raw.data() : buffer.encoded.data();
+    memcpy(buffer.bytes.data() + frame.offset, source, size);
+    buffer.writeOffset = static_cast<uint32_t>(frame.offset + size);
+    buffer.frameCount++;
+    FrameAt(buffer, buffer.frameCount - 1) = frame;
+    buffer.recordedBytes += size;
+    buffer.recordedFrames++;
+}
+
+bool RewindGameState(RewindBuffer& buffer, GameState& state) {
+    if (buffer.frameCount < 2) return false;
+
+    // The newest record is the current tick; its space is reused by the next record
+    buffer.frameCount--;
+    buffer.writeOffset = FrameAt(buffer, buffer.frameCount).offset;
+
+    const RewindFrame& frame = FrameAt(buffer, buffer.frameCount - 1);
+    uint8_t* raw = buffer.raw.data();
+    memcpy(raw, buffer.bytes.data() + frame.keyOffset, frame.rawSize);
+    if (!frame.keyframe) DecodeRewindDelta(buffer.bytes.data() + frame.offset, frame.size, raw);
+    ReadRewindRecord(raw, state);
+    StreamLevel(state);
+    return true;
+}
+
+float GetRewindSeconds(const RewindBuffer& buffer) {
+    return buffer.frameCount > 1 ? static_cast<float>(buffer.frameCount - 1) / ticksPerSecond : 0.0f;
+}
+
+size_t GetRewindBytesUsed(const RewindBuffer& buffer) {
+    if (buffer.frameCount == 0) return 0;
+    size_t head = buffer.frames[buffer.firstFrame].offset, tail = buffer.writeOffset;
+    return tail > head ? tail - head : buffer.bytes.size() - head + tail;
+}
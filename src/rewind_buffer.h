@@ -0,0 +1,68 @@
+#pragma once
+
+#include "game.h"
+#include <cstddef>
+#include <vector>
+
+// Sizes for a RewindBuffer; everything is allocated once by InitRewindBuffer
+struct RewindSettings {
+    int byteBudget;       // Encoded tick records kept, in bytes
+    int maxFrames;        // Ticks kept, at most
+    int keyframeInterval; // Ticks between full records; the rest are deltas against the last one
+};
+
+// 45 s of ticks in at most 512 KB of records: a keyframe (every 30th tick) is
+// about 300 bytes and a delta about 70-100, so 45 s needs roughly 200-300 KB
+RewindSettings DefaultRewindSettings();
+
+// Where one tick's record lives in the byte ring
+struct RewindFrame {
+    uint32_t offset;    // Encoded record
+    uint32_t size;
+    uint32_t keyOffset; // The keyframe it is a delta against (itself for a keyframe)
+    uint16_t rawSize;   // Decoded size, the same as its keyframe's
+    uint16_t keyDistance; // Ticks since its keyframe (0 for a keyframe)
+    bool keyframe;
+};
+
+// The last seconds of play, one record per tick, for stepping back in time.
+// A record holds what Step changes within a level (player, bats, flag, score,
+// camera, timers, RNG), not the level itself, so the buffer is cleared when the
+// level changes. Keyframes are stored whole; the ticks in between are stored as
+// XOR against their keyframe with the zero runs skipped, which leaves little
+// more than the moving bats. Records go into a fixed byte ring and the oldest
+// are dropped (a keyframe together with its deltas) to make room, so recording
+// and rewinding never allocate after InitRewindBuffer.
+struct RewindBuffer {
+    RewindSettings settings;
+    std::vector<uint8_t> bytes;        // Byte ring of encoded records
+    std::vector<RewindFrame> frames;   // Ring of frame entries, oldest at firstFrame
+    int firstFrame;
+    int frameCount;
+    uint32_t writeOffset;              // Where the next record goes, if it fits before the oldest
+    std::vector<uint8_t> raw;          // Scratch: a record being written or decoded
+    std::vector<uint8_t> encoded;      // Scratch: a delta being built
+
+    // Counters
+    int64_t recordedBytes;             // Sum of encoded sizes ever recorded
+    int64_t recordedFrames;
+    int64_t keyframes;
+};
+
+void InitRewindBuffer(RewindBuffer& buffer, const RewindSettings& settings);
+
+// Forget every tick (a new level started)
+void ClearRewindBuffer(RewindBuffer& buffer);
+
+// Append state as the newest tick, dropping the oldest ticks if there is no room
+void RecordRewindFrame(RewindBuffer& buffer, const GameState& state);
+
+// Step back one tick: drop the newest record and restore state to the one
+// before it. False (and state untouched) when no earlier tick is left.
+bool RewindGameState(RewindBuffer& buffer, GameState& state);
+
+// Seconds of play that can be rewound
+float GetRewindSeconds(const RewindBuffer& buffer);
+
+// Bytes of the ring in use by records (wasted space at the wrap included)
+size_t GetRewindBytesUsed(const RewindBuffer& buffer);
@@ -0,0 +1,129 @@
+#include "rollback.h"
+#include <algorithm>
+
+void InitVersus(VersusState& state, const LevelView& level) {
+    for (GameState& game : state.games) {
+        InitGame(game, level, defaultPlayerSpriteSize, defaultBatFrameSize);
+    }
+    state.winner = -1;
+    state.tick = 0;
+}
+
+void StepVersus(VersusState& state, InputFrame input0, InputFrame input1) {
+    state.tick++;
+    if (state.winner >= 0) return;
+    Step(state.games[0], input0);
+    Step(state.games[1], input1);
+    bool first = state.games[0].levelComplete, second = state.games[1].levelComplete;
+    if (first || second) state.winner = (first && second) ? 2 : (first ? 0 : 1);
+}
+
+uint64_t HashVersusState(const VersusState& state) {
+    // FNV-1a over the two game hashes and the result
+    uint64_t hash = 1469598103934665603ull;
+    uint64_t parts[4] = {HashGameState(state.games[0]), HashGameState(state.games[1]),
+                         static_cast<uint64_t>(state.winner), state.tick};
+    for (uint64_t part : parts) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (part >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void BeginRollbackSession(RollbackSession& session, int localPlayer, uint64_t seed, int levelChunks) {
+    LevelSettings settings = DefaultLevelSettings(levelChunks);
+    settings.playerSize = {defaultPlayerSpriteSize.x * batScale, defaultPlayerSpriteSize.y * batScale};
+    GenerateLevel(session.level, seed, settings, session.validator);
+    BakeLevel(session.level, session.baked);
+    InitVersus(session.state, session.baked.view);
+
+    session.localPlayer = localPlayer;
+    for (auto& player : session.inputs) {
+        std::fill(player, player + rollbackInputRing, 0);
+    }
+    session.remoteConfirmed = -1;
+    session.localAcked = -1;
+    session.rollbackFrom = -1;
+    session.rollbacks = 0;
+    session.resimulatedTicks = 0;
+    session.maxRollbackTicks = 0;
+    session.stalledTicks = 0;
+}
+
+static int64_t SessionTick(const RollbackSession& session) {
+    return static_cast<int64_t>(session.state.tick);
+}
+
+bool CanAdvanceRollbackSession(const RollbackSession& session) {
+    int64_t tick = SessionTick(session);
+    return tick - (session.remoteConfirmed + 1) < rollbackMaxTicks &&
+           tick - (session.localAcked + 1) < rollbackInputRing - 1;
+}
+
+// Remote buttons for a tick: known, or the last known ones held
+static uint8_t RemoteInput(const RollbackSession& session, int64_t tick) {
+    int remote = 1 - session.localPlayer;
+    if (tick <= session.remoteConfirmed) return session.inputs[remote][tick % rollbackInputRing];
+    if (session.remoteConfirmed < 0) return 0;
+    return session.inputs[remote][session.remoteConfirmed % rollbackInputRing];
+}
+
+// Save the state before the tick, then step it with the stored local and (known or predicted) remote input
+static void SimulateTick(RollbackSession& session) {
+    int64_t tick = SessionTick(session);
+    int remote = 1 - session.localPlayer;
+    uint8_t remoteButtons = RemoteInput(session, tick);
+    session.inputs[remote][tick % rollbackInputRing] = remoteButtons;
+    session.saved[tick % (rollbackMaxTicks + 1)] = session.state;
+
+    InputFrame inputs[2];
+    inputs[session.localPlayer] = {session.inputs[session.localPlayer][tick % rollbackInputRing]};
+    inputs[remote] = {remoteButtons};
+    StepVersus(session.state, inputs[0], inputs[1]);
+}
+
+void ApplyRollback(RollbackSession& session) {
+    if (session.rollbackFrom < 0) return;
+    int64_t from = session.rollbackFrom, to = SessionTick(session);
+    session.rollbackFrom = -1;
+    session.state = session.saved[from % (rollbackMaxTicks + 1)];
+    for (int64_t tick = from; tick < to; tick++) {
+        SimulateTick(session);
+    }
+    int depth = static_cast<int>(to - from);
+    session.rollbacks++;
+    session.resimulatedTicks += depth;
+    session.maxRollbackTicks = std::max(session.maxRollbackTicks, depth);
+}
+
+void AdvanceRollbackSession(RollbackSession& session, InputFrame local) {
+    ApplyRollback(session);
+    session.inputs[session.localPlayer][SessionTick(session) % rollbackInputRing] = local.buttons;
+    SimulateTick(session);
+}
+
+void AddRemoteInputs(RollbackSession& session, int64_t firstTick, const uint8_t* buttons, int count) {
+    int remote = 1 - session.localPlayer;
+    int64_t tick = SessionTick(session);
+    for (int i = 0; i < count; i++) {
+        int64_t inputTick = firstTick + i;
+        if (inputTick != session.remoteConfirmed + 1) continue;
+        uint8_t& slot = session.inputs[remote][inputTick % rollbackInputRing];
+        // Already simulated on a guess: a wrong guess means redoing from here
+        if (inputTick < tick && slot != buttons[i] && session.rollbackFrom < 0) {
+            session.rollbackFrom = inputTick;
+        }
+        slot = buttons[i];
+        session.remoteConfirmed = inputTick;
+    }
+}
+
+void AcknowledgeLocalInputs(RollbackSession& session, int64_t tick) {
+    session.localAcked = std::max(session.localAcked, std::min(tick, SessionTick(session) - 1));
+}
+
+uint8_t GetLocalInput(const RollbackSession& session, int64_t tick) {
+    return session.inputs[session.localPlayer][tick % rollbackInputRing];
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "game.h"
+#include "level_generator.h"
+
+// Two-player versus race: both players run the same level in their own
+// GameState, and the first to reach the flag wins. Sprite sizes come from
+// defaultPlayerSpriteSize/defaultBatFrameSize on both machines, so the two
+// simulations agree even if one of them is missing the art.
+struct VersusState {
+    GameState games[2];
+    int winner; // -1 while racing, 0 or 1, or 2 for a draw (both reached the flag on the same tick)
+    uint64_t tick;  // StepVersus calls, including those after the race was decided
+};
+
+// Start a race on level (which must outlive the state)
+void InitVersus(VersusState& state, const LevelView& level);
+
+// One tick for both players; once there is a winner only the tick count moves
+void StepVersus(VersusState& state, InputFrame input0, InputFrame input1);
+
+uint64_t HashVersusState(const VersusState& state);
+
+const int rollbackMaxTicks = 12;  // Furthest the simulation runs ahead of the remote player's known input
+const int rollbackInputRing = 64; // Ticks of input kept per player (more than rollbackMaxTicks + packet span)
+
+// Rollback netcode for one side of a versus match. The local player's input
+// is used on the tick it is read, with no input delay. The remote player's
+// input for ticks not received yet is predicted (their last known buttons held).
+// When their real input arrives and differs, the state saved before the first
+// wrong tick is restored and the ticks since are simulated again. Saved states
+// are copied into a fixed ring, which reuses the vectors' memory, so a
+// steady-state tick does not allocate.
+struct RollbackSession {
+    int localPlayer;           // 0 or 1
+    VersusState state;         // At tick state.tick, possibly built on predicted input
+    VersusState saved[rollbackMaxTicks + 1]; // saved[t % size]: state before tick t
+    uint8_t inputs[2][rollbackInputRing];   // Buttons per player by tick % rollbackInputRing (predictions included)
+    int64_t remoteConfirmed;   // Last tick whose remote input is known (-1: none yet)
+    int64_t localAcked;        // Last tick whose local input the remote has confirmed (-1: none yet)
+    int64_t rollbackFrom;      // First tick simulated with a wrong prediction, or -1
+
+    // Level both states point into
+    LevelValidator validator;
+    Level level;
+    BakedLevel baked;
+
+    // Counters
+    int rollbacks;
+    int64_t resimulatedTicks;
+    int maxRollbackTicks;
+    int64_t stalledTicks;      // Ticks the caller skipped because CanAdvanceRollbackSession said no
+};
+
+// Generate the level for seed and start both players on it
+void BeginRollbackSession(RollbackSession& session, int localPlayer, uint64_t seed,
+                          int levelChunks = defaultLevelChunks);
+
+// Whether the next tick may run: the remote input must be less than
+// rollbackMaxTicks behind, or a wrong guess could no longer be rolled back, and
+// the local input the remote has not confirmed must still be in the input ring
+bool CanAdvanceRollbackSession(const RollbackSession& session);
+
+// Redo mispredicted ticks if new remote input showed any, then run one tick
+// with the local input. Check CanAdvanceRollbackSession first.
+void AdvanceRollbackSession(RollbackSession& session, InputFrame local);
+
+// Redo mispredicted ticks without running a new one
+void ApplyRollback(RollbackSession& session);
+
+// Remote buttons for ticks firstTick..firstTick+count-1; already known ticks
+// are skipped, so the same input may arrive any number of times. Input after
+// a gap is ignored until the gap is filled (the sender repeats unacknowledged
+// ticks in every packet).
+void AddRemoteInputs(RollbackSession& session, int64_t firstTick, const uint8_t* buttons, int count);
+
+// The remote has confirmed the local input up to tick
+void AcknowledgeLocalInputs(RollbackSession& session, int64_t tick);
+
+// The local buttons for tick (not yet acknowledged, or within the last rollbackInputRing ticks)
+uint8_t GetLocalInput(const RollbackSession& session, int64_t tick);
@@ -0,0 +1,190 @@
+#include "sim_thread.h"
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+
+void CaptureGameSnapshot(const GameState& state, int levelIndex, GameSnapshot& snapshot) {
+    snapshot.cameraX = state.cameraX;
+    snapshot.player = state.player;
+    snapshot.bats = state.bats;
+    snapshot.flag = state.flag;
+    snapshot.score = state.score;
+    snapshot.levelComplete = state.levelComplete;
+    snapshot.levelIndex = levelIndex;
+    snapshot.worldRevision = state.world.revision;
+    snapshot.chunks = state.world.chunks;
+    snapshot.versus = false;
+    snapshot.versusWinner = -1;
+    snapshot.waitingForPeer = false;
+    snapshot.rewinding = false;
+    snapshot.rewindSeconds = 0;
+}
+
+// The versus fields on top of the local player's game
+static void CaptureVersusSnapshot(const RollbackSession& session, const NetPeer& peer, GameSnapshot& snapshot) {
+    CaptureGameSnapshot(session.state.games[session.localPlayer], 0, snapshot);
+    snapshot.versus = true;
+    snapshot.rival = session.state.games[1 - session.localPlayer].player;
+    snapshot.versusWinner = session.state.winner;
+    snapshot.waitingForPeer = !peer.connected;
+}
+
+double SimClockSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+float GetSnapshotInterpolationAlpha(const GameSnapshot& snapshot) {
+    float alpha = static_cast<float>((SimClockSeconds() - snapshot.time) * ticksPerSecond);
+    return alpha < 0 ? 0 : (alpha > 1 ? 1 : alpha);
+}
+
+void PublishButtons(SharedButtons& buttons, uint8_t held) {
+    buttons.down.store(held, std::memory_order_relaxed);
+    buttons.sinceTick.fetch_or(held, std::memory_order_relaxed);
+}
+
+InputFrame TakeButtons(SharedButtons& buttons) {
+    return {buttons.sinceTick.exchange(buttons.down.load(std::memory_order_relaxed), std::memory_order_relaxed)};
+}
+
+// One tick: input, Step, level changes, or a step back while rewinding.
+// previous gets the positions before it.
+static void RunTick(SimThread& sim, InterpolationFrame& previous) {
+    GameState& state = *sim.state;
+
+    // Recorded input while a replay lasts, then the keyboard (or bot) takes over
+    bool replayTickUsed = sim.replay && sim.replayTick < sim.replay->buttons.size();
+    if (sim.rewind && !replayTickUsed && sim.rewinding.load(std::memory_order_relaxed)) {
+        CapturePositions(state, previous);
+        if (RewindGameState(*sim.rewind, state) && sim.recording) {
+            sim.recording->buttons.pop_back(); // A replay must not see the undone tick
+        }
+        return;
+    }
+    InputFrame input = replayTickUsed ? InputFrame{sim.replay->buttons[sim.replayTick++]} : sim.input(state);
+    if (sim.recording) sim.recording->buttons.push_back(input.buttons);
+
+    CapturePositions(state, previous);
+    Step(state, input);
+    if (UpdateLevelSequence(*sim.sequence, state)) {
+        CapturePositions(state, previous); // New level: nothing to interpolate from
+        if (sim.rewind) ClearRewindBuffer(*sim.rewind);
+    }
+    if (sim.rewind) RecordRewindFrame(*sim.rewind, state);
+    if (replayTickUsed && sim.replayTick == sim.replay->buttons.size() && sim.replay->finalHash != 0) {
+        bool inSync = HashGameState(state) == sim.replay->finalHash;
+        printf("Replay finished %s\n", inSync ? "in sync" : "with a DESYNC");
+    }
+}
+
+// One versus tick: trade input with the peer, then advance unless this side is
+// too far ahead. A tick that does not advance leaves the buttons for the next.
+static void RunVersusTick(SimThread& sim, InterpolationFrame& previous) {
+    RollbackSession& session = *sim.versus;
+    double now = SimClockSeconds();
+    PollNetPeer(*sim.peer, session, now);
+    CapturePositions(*sim.state, previous);
+    if (ShouldWaitForPeer(*sim.peer, session)) {
+        // Let the peer catch up
+    } else if (!CanAdvanceRollbackSession(session)) {
+        session.stalledTicks++;
+    } else {
+        AdvanceRollbackSession(session, sim.input(*sim.state));
+    }
+    SendNetInputs(*sim.peer, session, now);
+}
+
+static void CaptureSimSnapshot(const SimThread& sim, GameSnapshot& snapshot) {
+    if (sim.versus) {
+        CaptureVersusSnapshot(*sim.versus, *sim.peer, snapshot);
+    } else {
+        CaptureGameSnapshot(*sim.state, sim.sequence->levelIndex, snapshot);
+    }
+    if (sim.rewind) {
+        snapshot.rewinding = sim.rewinding.load(std::memory_order_relaxed) && sim.rewind->frameCount > 1;
+        snapshot.rewindSeconds = static_cast<int>(GetRewindSeconds(*sim.rewind));
+    }
+}
+
+static void RunSimThread(SimThread& sim) {
+    FixedTimestep timestep;
+    InitFixedTimestep(timestep, ticksPerSecond, 5);
+    double last = SimClockSeconds();
+    while (sim.running.load(std::memory_order_acquire)) {
+        // Run as many fixed ticks as the elapsed time covers (usually 1) and publish the result
+        double now = SimClockSeconds();
+        int ticks = AdvanceFixedTimestep(timestep, now - last);
+        last = now;
+        if (ticks > 0) {
+            GameSnapshot& snapshot = GetTripleBufferBack(sim.snapshots);
+            snapshot.stepStart = ProfilerNowNanoseconds();
+            for (int t = 0; t < ticks; t++) {
+                if (sim.versus) {
+                    RunVersusTick(sim, snapshot.previous);
+                } else {
+                    RunTick(sim, snapshot.previous);
+                }
+            }
+            CaptureSimSnapshot(sim, snapshot);
+            snapshot.time = now - timestep.accumulator;
+            snapshot.stepEnd = ProfilerNowNanoseconds();
+            PublishTripleBuffer(sim.snapshots);
+        }
+
+        // Sleep until the next tick is due
+        double wait = timestep.tickSeconds - timestep.accumulator - (SimClockSeconds() - now);
+        if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+}
+
+static void LaunchSimThread(SimThread& sim) {
+    // The renderer has something to draw before the first tick
+    InitTripleBuffer(sim.snapshots);
+    GameSnapshot& first = GetTripleBufferBack(sim.snapshots);
+    CapturePositions(*sim.state, first.previous);
+    CaptureSimSnapshot(sim, first);
+    first.time = SimClockSeconds();
+    first.stepStart = first.stepEnd = ProfilerNowNanoseconds();
+    PublishTripleBuffer(sim.snapshots);
+
+    sim.running.store(true, std::memory_order_release);
+    sim.thread = std::thread(RunSimThread, std::ref(sim));
+}
+
+void StartSimThread(SimThread& sim, GameState& state, LevelSequence& sequence, InputProvider input,
+                    const InputRecording* replay, InputRecording* recording, RewindBuffer* rewind) {
+    sim.state = &state;
+    sim.sequence = &sequence;
+    sim.versus = nullptr;
+    sim.peer = nullptr;
+    sim.input = std::move(input);
+    sim.replay = replay;
+    sim.replayTick = 0;
+    sim.recording = recording;
+    sim.rewind = rewind;
+    sim.rewinding.store(false, std::memory_order_relaxed);
+    if (rewind) {
+        ClearRewindBuffer(*rewind);
+        RecordRewindFrame(*rewind, state);
+    }
+    LaunchSimThread(sim);
+}
+
+void StartVersusSimThread(SimThread& sim, RollbackSession& session, NetPeer& peer, InputProvider input) {
+    sim.state = &session.state.games[session.localPlayer];
+    sim.sequence = nullptr;
+    sim.versus = &session;
+    sim.peer = &peer;
+    sim.input = std::move(input);
+    sim.replay = nullptr;
+    sim.replayTick = 0;
+    sim.recording = nullptr;
+    sim.rewind = nullptr;
+    sim.rewinding.store(false, std::memory_order_relaxed);
+    LaunchSimThread(sim);
+}
+
+void StopSimThread(SimThread& sim) {
+    sim.running.store(false, std::memory_order_release);
+    if (sim.thread.joinable()) sim.thread.join();
+}
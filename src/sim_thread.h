@@ -0,0 +1,92 @@
+#pragma once
+
+#include "bot.h"
+#include "fixed_timestep.h"
+#include "input_recording.h"
+#include "level_sequence.h"
+#include "netplay.h"
+#include "rewind_buffer.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <thread>
+
+// What the renderer needs from one tick, copied out of the GameState by the
+// simulation thread. Once published it is never written again until the
+// renderer has let go of it.
+struct GameSnapshot {
+    double time;                  // SimClockSeconds() at which this tick was due
+    InterpolationFrame previous;  // Positions before the tick, to draw in between
+    float cameraX;
+    Player player;
+    BatSwarm bats;
+    Flag flag;
+    Score score;
+    bool levelComplete;
+    int levelIndex;                  // LevelSequence::levelIndex; changes when a new level is swapped in
+    uint32_t worldRevision;          // World::revision of chunks
+    std::vector<WorldChunk> chunks;  // Resident world chunks, for the tilemap
+    bool versus;                     // A versus match: the fields below are set
+    Player rival;                    // The other player, as far as their input is known or predicted
+    int versusWinner;                // VersusState::winner, or -1 while racing
+    bool waitingForPeer;             // No packet from the other side yet
+    bool rewinding;                  // This tick was a step back
+    int rewindSeconds;               // Whole seconds that can still be rewound
+    int64_t stepStart;               // ProfilerNowNanoseconds() around the ticks that produced it
+    int64_t stepEnd;
+};
+
+void CaptureGameSnapshot(const GameState& state, int levelIndex, GameSnapshot& snapshot);
+
+// Seconds on the monotonic clock shared by both threads
+double SimClockSeconds();
+
+// How far the current time is between the snapshot's tick and the next, in [0, 1]
+float GetSnapshotInterpolationAlpha(const GameSnapshot& snapshot);
+
+// Keyboard state handed from the render thread (which owns the window and its
+// input) to the simulation thread. Keys held during any render frame since the
+// last tick count for the next one, so a tap shorter than a tick is not lost.
+struct SharedButtons {
+    std::atomic<uint8_t> down;      // Held in the latest render frame
+    std::atomic<uint8_t> sinceTick; // Held in any render frame since the last tick
+};
+
+// Render thread, once per frame
+void PublishButtons(SharedButtons& buttons, uint8_t held);
+
+// Simulation thread, once per tick
+InputFrame TakeButtons(SharedButtons& buttons);
+
+// Runs the fixed 60 Hz simulation on its own thread, so a slow render frame
+// delays neither the ticks nor input sampling. The thread owns the GameState
+// and LevelSequence (or the versus session and peer) while it runs; the
+// renderer only reads snapshots.
+struct SimThread {
+    GameState* state;              // The local player's game
+    LevelSequence* sequence;       // Null in a versus match
+    RollbackSession* versus;       // Set in a versus match
+    NetPeer* peer;
+    InputProvider input;           // Buttons for every tick not covered by replay
+    const InputRecording* replay;  // Played first when set
+    size_t replayTick;
+    InputRecording* recording;     // Every tick's buttons are appended when set
+    RewindBuffer* rewind;          // Every tick is recorded here when set
+    std::atomic<bool> rewinding;   // Set by the renderer while the rewind key is held
+    TripleBuffer<GameSnapshot> snapshots;
+    std::atomic<bool> running;
+    std::thread thread;
+};
+
+// Publish a snapshot of the current state and start ticking. replay,
+// recording and rewind may be null. While rewinding is set each tick steps
+// back one tick instead (and drops that tick from the recording); the
+// buffer is cleared when the level changes.
+void StartSimThread(SimThread& sim, GameState& state, LevelSequence& sequence, InputProvider input,
+                    const InputRecording* replay, InputRecording* recording, RewindBuffer* rewind);
+
+// Same for the local side of a versus match: each tick polls the peer,
+// advances the rollback session with the local input and sends it out
+void StartVersusSimThread(SimThread& sim, RollbackSession& session, NetPeer& peer, InputProvider input);
+
+// Stop ticking and wait for the thread; the state is the caller's again
+void StopSimThread(SimThread& sim);
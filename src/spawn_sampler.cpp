@@ -0,0 +1,90 @@
+#include "spawn_sampler.h"
+#include "game.h"
+#include <algorithm>
+
+void InitSpawnSampler(SpawnSampler& sampler, int cellSize) {
+    sampler.cellSize = std::max(1, cellSize);
+    sampler.columns = 0;
+    sampler.rows = 0;
+    sampler.band = {0, 0, 0, 0};
+    sampler.minDistance = 0;
+    sampler.players.clear();
+    sampler.validCells.clear();
+    sampler.rowGaps.clear();
+    sampler.built = false;
+}
+
+static bool SameSpawnQuery(const SpawnSampler& sampler, Rectangle band, const Vector2* players, int playerCount,
+                           float minDistance) {
+    if (!sampler.built || sampler.minDistance != minDistance || static_cast<int>(sampler.players.size()) != playerCount ||
+        sampler.band.x != band.x || sampler.band.y != band.y || sampler.band.width != band.width ||
+        sampler.band.height != band.height) {
+        return false;
+    }
+    for (int p = 0; p < playerCount; p++) {
+        if (sampler.players[p].x != players[p].x || sampler.players[p].y != players[p].y) return false;
+    }
+    return true;
+}
+
+// Squared distance from point to the nearest point of [minX, maxX] along one axis
+static float AxisGapSquared(float point, float minX, float maxX) {
+    float gap = point < minX ? minX - point : (point > maxX ? point - maxX : 0.0f);
+    return gap * gap;
+}
+
+void UpdateSpawnSampler(SpawnSampler& sampler, Rectangle band, const Vector2* players, int playerCount,
+                        float minDistance) {
+    if (SameSpawnQuery(sampler, band, players, playerCount, minDistance)) return;
+    sampler.band = band;
+    sampler.minDistance = minDistance;
+    sampler.players.assign(players, players + playerCount);
+    sampler.built = true;
+
+    // Positions are whole pixels from 0 to the spread, like RandomInt(0, spread)
+    const int spreadX = std::max(0, static_cast<int>(band.width));
+    const int spreadY = std::max(0, static_cast<int>(band.height));
+    const int cell = sampler.cellSize;
+    sampler.columns = spreadX / cell + 1;
+    sampler.rows = spreadY / cell + 1;
+    const float minDistanceSquared = minDistance * minDistance;
+
+    // A cell is valid when even its point nearest to each player is far enough away
+    sampler.rowGaps.resize(playerCount);
+    float* rowGaps = sampler.rowGaps.data();
+    sampler.validCells.clear();
+    for (int row = 0; row < sampler.rows; row++) {
+        float top = band.y + row * cell;
+        float bottom = band.y + std::min(row * cell + cell - 1, spreadY);
+        bool rowClear = true;
+        for (int p = 0; p < playerCount; p++) {
+            rowGaps[p] = AxisGapSquared(players[p].y, top, bottom);
+            if (rowGaps[p] < minDistanceSquared) rowClear = false;
+        }
+        for (int column = 0; column < sampler.columns; column++) {
+            bool valid = true;
+            if (!rowClear) {
+                float left = band.x + column * cell;
+                float right = band.x + std::min(column * cell + cell - 1, spreadX);
+                for (int p = 0; p < playerCount && valid; p++) {
+                    valid = AxisGapSquared(players[p].x, left, right) + rowGaps[p] >= minDistanceSquared;
+                }
+            }
+            if (valid) sampler.validCells.push_back(row * sampler.columns + column);
+        }
+    }
+}
+
+bool SampleSpawnPoint(const SpawnSampler& sampler, Rng& rng, Vector2& position) {
+    if (sampler.validCells.empty()) return false;
+    int index = sampler.validCells[RandomInt(rng, 0, static_cast<int>(sampler.validCells.size()) - 1)];
+    int row = index / sampler.columns;
+    int column = index % sampler.columns;
+    int cell = sampler.cellSize;
+    int spreadX = std::max(0, static_cast<int>(sampler.band.width));
+    int spreadY = std::max(0, static_cast<int>(sampler.band.height));
+    int x = column * cell + RandomInt(rng, 0, std::min(cell - 1, spreadX - column * cell));
+    int y = row * cell + RandomInt(rng, 0, std::min(cell - 1, spreadY - row * cell));
+    position = {sampler.band.x + x, sampler.band.y + y};
+    return true;
+}
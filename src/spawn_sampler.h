@@ -0,0 +1,35 @@
+#pragma once
+
+#include "raylib.h" // Vector2 / Rectangle
+#include <cstdint>
+#include <vector>
+
+struct Rng;
+
+// Spawn positions on a lattice of cells over a band (the range of allowed
+// top-left corners). UpdateSpawnSampler lists the cells that are far enough
+// from every player, in one pass over the cells with squared distances, and
+// SampleSpawnPoint then picks from that list in constant time. Spawning many
+// enemies in one tick costs one update plus O(1) per enemy, with no retries.
+struct SpawnSampler {
+    int cellSize;                // Pixels per cell side; a sample is a random point in its cell
+    int columns, rows;
+    Rectangle band;              // What validCells was built for
+    float minDistance;
+    std::vector<Vector2> players;
+    std::vector<int32_t> validCells; // row * columns + column
+    std::vector<float> rowGaps;      // Scratch: each player's squared distance to the current row
+    bool built;
+};
+
+void InitSpawnSampler(SpawnSampler& sampler, int cellSize = 16);
+
+// List the cells of band whose every point is at least minDistance from all
+// players. band.width/height are the spread of positions (0 = one column/row).
+// Does nothing when called again with the same arguments, so a batch of
+// respawns in one tick shares one update.
+void UpdateSpawnSampler(SpawnSampler& sampler, Rectangle band, const Vector2* players, int playerCount,
+                        float minDistance);
+
+// A random whole-pixel position in a random valid cell; false if none is valid
+bool SampleSpawnPoint(const SpawnSampler& sampler, Rng& rng, Vector2& position);
@@ -0,0 +1,131 @@
+#include "texture_atlas.h"
+#include "procedural_image.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+static const int atlasPadding = 2;
+static const char* atlasTableHeader = "# findtreasure atlas v1: name x y width height sourceWidth sourceHeight fromFile";
+
+bool PackAtlasRects(const std::vector<Vector2>& sizes, int padding, int maxWidth,
+                    std::vector<Rectangle>& placed, int& width, int& height) {
+    placed.assign(sizes.size(), {0, 0, 0, 0});
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a].y > sizes[b].y; });
+
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+    width = height = 0;
+    for (size_t index : order) {
+        int w = static_cast<int>(sizes[index].x), h = static_cast<int>(sizes[index].y);
+        if (w + padding > maxWidth) return false;
+        if (shelfX + w + padding > maxWidth) {
+            // Start a new shelf below the current one
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        placed[index] = {static_cast<float>(shelfX), static_cast<float>(shelfY),
+                         static_cast<float>(w), static_cast<float>(h)};
+        shelfX += w + padding;
+        shelfHeight = std::max(shelfHeight, h + padding);
+        width = std::max(width, shelfX);
+        height = std::max(height, shelfY + shelfHeight);
+    }
+    return true;
+}
+
+// "Missing texture" look for a sprite without a file: a checkerboard of its
+// fallback color and a darker shade, four cells across the shorter side
+static Image GenMissingSpriteImage(const AtlasSprite& sprite) {
+    Color dark = {static_cast<unsigned char>(sprite.fallbackColor.r / 2),
+                  static_cast<unsigned char>(sprite.fallbackColor.g / 2),
+                  static_cast<unsigned char>(sprite.fallbackColor.b / 2), sprite.fallbackColor.a};
+    int cellSize = std::max(1, std::min(sprite.fallbackWidth, sprite.fallbackHeight) / 4);
+    return GenImageCheckerboard(sprite.fallbackWidth, sprite.fallbackHeight, cellSize, sprite.fallbackColor, dark);
+}
+
+Image DecodeAtlasSprite(const AtlasSprite& sprite, AtlasFrame& frame) {
+    frame.name = sprite.name;
+    frame.source = {0, 0, 0, 0};
+    frame.fromFile = FileExists(sprite.path.c_str());
+    Image img = frame.fromFile ? LoadImage(sprite.path.c_str()) : GenMissingSpriteImage(sprite);
+    ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    frame.sourceSize = {static_cast<float>(img.width), static_cast<float>(img.height)};
+    if (frame.fromFile && sprite.packScale != 1.0f) {
+        ImageResize(&img, std::max(1, static_cast<int>(std::lround(img.width * sprite.packScale))),
+                    std::max(1, static_cast<int>(std::lround(img.height * sprite.packScale))));
+    }
+    return img;
+}
+
+Image PackAtlasImage(std::vector<Image>& images, std::vector<AtlasFrame>& frames) {
+    std::vector<Vector2> sizes;
+    for (const auto& img : images) {
+        sizes.push_back({static_cast<float>(img.width), static_cast<float>(img.height)});
+    }
+
+    // Try a few strip widths and keep the smallest atlas
+    std::vector<Rectangle> placed, bestPlaced;
+    int bestWidth = 0, bestHeight = 0;
+    for (int maxWidth : {256, 512, 1024, 2048, 4096}) {
+        int width, height;
+        if (!PackAtlasRects(sizes, atlasPadding, maxWidth, placed, width, height)) continue;
+        if (bestPlaced.empty() || static_cast<long>(width) * height < static_cast<long>(bestWidth) * bestHeight) {
+            bestPlaced = placed;
+            bestWidth = width;
+            bestHeight = height;
+        }
+    }
+
+    Image atlasImage = GenImageColor(std::max(bestWidth, 1), std::max(bestHeight, 1), BLANK);
+    for (size_t i = 0; i < images.size(); i++) {
+        Rectangle src = {0, 0, static_cast<float>(images[i].width), static_cast<float>(images[i].height)};
+        ImageDraw(&atlasImage, images[i], src, bestPlaced[i], WHITE);
+        frames[i].source = bestPlaced[i];
+        UnloadImage(images[i]);
+    }
+    images.clear();
+    return atlasImage;
+}
+
+std::string SerializeAtlasFrames(const std::vector<AtlasFrame>& frames) {
+    std::ostringstream table;
+    table << atlasTableHeader << "\n";
+    for (const auto& frame : frames) {
+        table << frame.name << " " << frame.source.x << " " << frame.source.y << " "
+              << frame.source.width << " " << frame.source.height << " "
+              << frame.sourceSize.x << " " << frame.sourceSize.y << " " << (frame.fromFile ? 1 : 0) << "\n";
+    }
+    return table.str();
+}
+
+bool ParseAtlasFrames(const std::string& text, std::vector<AtlasFrame>& frames) {
+    std::istringstream table(text);
+    std::string line;
+    if (!std::getline(table, line) || line != atlasTableHeader) return false;
+
+    frames.clear();
+    AtlasFrame frame;
+    int fromFile = 0;
+    while (table >> frame.name >> frame.source.x >> frame.source.y >> frame.source.width >> frame.source.height
+                 >> frame.sourceSize.x >> frame.sourceSize.y >> fromFile) {
+        frame.fromFile = fromFile != 0;
+        frames.push_back(frame);
+    }
+    return true;
+}
+
+const AtlasFrame* FindAtlasFrame(const TextureAtlas& atlas, const std::string& name) {
+    for (const auto& frame : atlas.frames) {
+        if (frame.name == name) return &frame;
+    }
+    return nullptr;
+}
+
+void UnloadTextureAtlas(TextureAtlas& atlas) {
+    UnloadTexture(atlas.texture);
+    atlas.texture = {};
+    atlas.frames.clear();
+}
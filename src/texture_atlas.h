@@ -0,0 +1,51 @@
+#pragma once
+
+#include "raylib.h"
+#include <string>
+#include <vector>
+
+// One image to place in the atlas
+struct AtlasSprite {
+    std::string name;
+    std::string path;      // Source PNG; a checkerboard fallback is packed if it is missing
+    float packScale;       // Resolution stored in the atlas relative to the source (sprites drawn small can shrink)
+    int fallbackWidth;
+    int fallbackHeight;
+    Color fallbackColor;
+};
+
+// Entry of the generated frame table
+struct AtlasFrame {
+    std::string name;
+    Rectangle source;      // Pixel rect inside the atlas texture
+    Vector2 sourceSize;    // Size of the original image (what the game logic sizes against)
+    bool fromFile;         // False when the fallback checkerboard was packed
+};
+
+struct TextureAtlas {
+    Texture2D texture;
+    std::vector<AtlasFrame> frames;
+};
+
+// Shelf-pack rects (tallest first) into a strip maxWidth wide. Writes each
+// rect's position into placed and the used atlas size; false if maxWidth is too narrow.
+bool PackAtlasRects(const std::vector<Vector2>& sizes, int padding, int maxWidth,
+                    std::vector<Rectangle>& placed, int& width, int& height);
+
+// Decode one sprite (or synthesize its fallback) as RGBA8 at its packed
+// resolution and fill frame's name/sourceSize/fromFile. CPU only, so it is
+// safe to call from worker threads.
+Image DecodeAtlasSprite(const AtlasSprite& sprite, AtlasFrame& frame);
+
+// Pack decoded sprite images into one RGBA8 image (smallest of a few strip
+// widths) and fill each frame's source rect. The input images are unloaded.
+Image PackAtlasImage(std::vector<Image>& images, std::vector<AtlasFrame>& frames);
+
+// Text form of the frame table, stored alongside the packed image
+std::string SerializeAtlasFrames(const std::vector<AtlasFrame>& frames);
+bool ParseAtlasFrames(const std::string& text, std::vector<AtlasFrame>& frames);
+
+// Frame by name, or nullptr
+const AtlasFrame* FindAtlasFrame(const TextureAtlas& atlas, const std::string& name);
+
+void UnloadTextureAtlas(TextureAtlas& atlas);
@@ -0,0 +1,187 @@
+#include "tilemap_renderer.h"
+#include "game.h"
+#include "rlgl.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+
+// Mesh indices are 16-bit, so one mesh holds at most 65536 / 4 quads
+static const int maxQuadsPerMesh = 16384;
+
+// Upload one mesh of textured quads (two triangles each, TL-BL-BR / TL-BR-TR like rlgl's quads)
+static TilemapChunk BuildChunkMesh(const std::vector<Rectangle>& quads, const std::vector<Rectangle>& uvs,
+                                   size_t first, size_t count) {
+    TilemapChunk chunk = {};
+    Mesh& mesh = chunk.mesh;
+    mesh.vertexCount = static_cast<int>(count * 4);
+    mesh.triangleCount = static_cast<int>(count * 2);
+    // Mesh buffers are released by UnloadMesh, so they must come from raylib's allocator
+    mesh.vertices = static_cast<float*>(MemAlloc(mesh.vertexCount * 3 * sizeof(float)));
+    mesh.texcoords = static_cast<float*>(MemAlloc(mesh.vertexCount * 2 * sizeof(float)));
+    mesh.indices = static_cast<unsigned short*>(MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short)));
+
+    float minX = quads[first].x, minY = quads[first].y;
+    float maxX = minX, maxY = minY;
+    for (size_t q = 0; q < count; q++) {
+        const Rectangle& r = quads[first + q];
+        const Rectangle& uv = uvs[first + q];
+        float corners[4][4] = {
+            {r.x,           r.y,            uv.x,            uv.y},
+            {r.x,           r.y + r.height, uv.x,            uv.y + uv.height},
+            {r.x + r.width, r.y + r.height, uv.x + uv.width, uv.y + uv.height},
+            {r.x + r.width, r.y,            uv.x + uv.width, uv.y}
+        };
+        for (int c = 0; c < 4; c++) {
+            size_t v = q * 4 + c;
+            mesh.vertices[v * 3 + 0] = corners[c][0];
+            mesh.vertices[v * 3 + 1] = corners[c][1];
+            mesh.vertices[v * 3 + 2] = 0.0f;
+            mesh.texcoords[v * 2 + 0] = corners[c][2];
+            mesh.texcoords[v * 2 + 1] = corners[c][3];
+        }
+        unsigned short base = static_cast<unsigned short>(q * 4);
+        unsigned short* index = mesh.indices + q * 6;
+        index[0] = base; index[1] = base + 1; index[2] = base + 2;
+        index[3] = base; index[4] = base + 2; index[5] = base + 3;
+
+        minX = std::min(minX, r.x);
+        minY = std::min(minY, r.y);
+        maxX = std::max(maxX, r.x + r.width);
+        maxY = std::max(maxY, r.y + r.height);
+    }
+    chunk.area = {minX, minY, maxX - minX, maxY - minY};
+
+    UploadMesh(&mesh, false);
+    return chunk;
+}
+
+void InitTilemap(TilemapRenderer& tilemap, Texture2D texture, Rectangle source, float chunkWidth) {
+    UnloadTilemap(tilemap);
+    tilemap.texture = texture;
+    for (Rectangle& tileSource : tilemap.sources) {
+        tileSource = source;
+    }
+    tilemap.chunkWidth = chunkWidth;
+    tilemap.material = LoadMaterialDefault();
+    SetMaterialTexture(&tilemap.material, MATERIAL_MAP_DIFFUSE, texture);
+}
+
+void SetTilemapTileSource(TilemapRenderer& tilemap, TileKind kind, Rectangle source) {
+    tilemap.sources[kind] = source;
+}
+
+void AddTilemapPlatforms(TilemapRenderer& tilemap, const Platform* platforms, const uint8_t* tiles, size_t count,
+                         int key) {
+    if (count == 0) return;
+    const Texture2D& texture = tilemap.texture;
+    const float chunkWidth = tilemap.chunkWidth;
+
+    float minX = platforms[0].rect.x, maxX = minX;
+    for (size_t i = 0; i < count; i++) {
+        minX = std::min(minX, platforms[i].rect.x);
+        maxX = std::max(maxX, platforms[i].rect.x + platforms[i].rect.width);
+    }
+    float originX = std::floor(minX / chunkWidth) * chunkWidth;
+    size_t stripCount = static_cast<size_t>((maxX - originX) / chunkWidth) + 1;
+
+    // Cut every platform into tile-sized quads and bucket them by vertical strip
+    std::vector<std::vector<Rectangle>> stripQuads(stripCount), stripUvs(stripCount);
+    const float tile = static_cast<float>(tileSize);
+    for (size_t i = 0; i < count; i++) {
+        const Rectangle& rect = platforms[i].rect;
+
+        // Tile image in normalized texture coordinates
+        const Rectangle& source = tilemap.sources[tiles && tiles[i] < TILE_KIND_COUNT ? tiles[i] : static_cast<uint8_t>(TILE_GROUND)];
+        float u0 = source.x / texture.width, v0 = source.y / texture.height;
+        float uScale = source.width / texture.width, vScale = source.height / texture.height;
+        for (float y = rect.y; y < rect.y + rect.height; y += tile) {
+            float h = std::min(tile, rect.y + rect.height - y);
+            for (float x = rect.x; x < rect.x + rect.width; x += tile) {
+                float w = std::min(tile, rect.x + rect.width - x);
+                size_t strip = std::min(static_cast<size_t>((x - originX) / chunkWidth), stripCount - 1);
+                stripQuads[strip].push_back({x, y, w, h});
+                // Partial tiles at a platform's edge show the matching part of the image
+                stripUvs[strip].push_back({u0, v0, uScale * w / tile, vScale * h / tile});
+            }
+        }
+    }
+
+    for (size_t s = 0; s < stripCount; s++) {
+        const std::vector<Rectangle>& quads = stripQuads[s];
+        for (size_t first = 0; first < quads.size(); first += maxQuadsPerMesh) {
+            size_t quadCount = std::min(quads.size() - first, static_cast<size_t>(maxQuadsPerMesh));
+            tilemap.chunks.push_back(BuildChunkMesh(quads, stripUvs[s], first, quadCount));
+            tilemap.chunks.back().key = key;
+        }
+    }
+}
+
+void RemoveTilemapPlatforms(TilemapRenderer& tilemap, int key) {
+    for (size_t i = tilemap.chunks.size(); i-- > 0;) {
+        if (tilemap.chunks[i].key == key) {
+            UnloadMesh(tilemap.chunks[i].mesh);
+            tilemap.chunks.erase(tilemap.chunks.begin() + i);
+        }
+    }
+}
+
+void ClearTilemapPlatforms(TilemapRenderer& tilemap) {
+    for (auto& chunk : tilemap.chunks) {
+        UnloadMesh(chunk.mesh);
+    }
+    tilemap.chunks.clear();
+    tilemap.worldRevision = 0;
+}
+
+void SyncTilemapWithChunks(TilemapRenderer& tilemap, const std::vector<WorldChunk>& chunks, uint32_t worldRevision) {
+    if (tilemap.worldRevision == worldRevision) return;
+    tilemap.worldRevision = worldRevision;
+
+    auto resident = [&chunks](int index) {
+        return std::any_of(chunks.begin(), chunks.end(),
+                           [index](const WorldChunk& chunk) { return chunk.index == index; });
+    };
+    std::vector<int> evicted;
+    for (const auto& mesh : tilemap.chunks) {
+        if (!resident(mesh.key) && std::find(evicted.begin(), evicted.end(), mesh.key) == evicted.end()) {
+            evicted.push_back(mesh.key);
+        }
+    }
+    for (int key : evicted) {
+        RemoveTilemapPlatforms(tilemap, key);
+    }
+    for (const auto& chunk : chunks) {
+        bool built = std::any_of(tilemap.chunks.begin(), tilemap.chunks.end(),
+                                 [&chunk](const TilemapChunk& mesh) { return mesh.key == chunk.index; });
+        if (!built) {
+            AddTilemapPlatforms(tilemap, chunk.platforms.data(), chunk.tiles.data(), chunk.platforms.size(),
+                                chunk.index);
+        }
+    }
+}
+
+void DrawTilemap(const TilemapRenderer& tilemap, Rectangle view) {
+    if (tilemap.chunks.empty()) return;
+
+    // Flush queued 2D draws so the meshes layer correctly on top of them
+    rlDrawRenderBatchActive();
+    Matrix identity = MatrixIdentity();
+    for (const auto& chunk : tilemap.chunks) {
+        const Rectangle& a = chunk.area;
+        if (a.x + a.width < view.x || a.x > view.x + view.width ||
+            a.y + a.height < view.y || a.y > view.y + view.height) {
+            continue; // Off screen
+        }
+        DrawMesh(chunk.mesh, tilemap.material, identity);
+    }
+}
+
+void UnloadTilemap(TilemapRenderer& tilemap) {
+    ClearTilemapPlatforms(tilemap);
+
+    // Not UnloadMaterial: that would also unload the shared tile texture
+    if (tilemap.material.maps != nullptr) {
+        MemFree(tilemap.material.maps);
+        tilemap.material.maps = nullptr;
+    }
+}
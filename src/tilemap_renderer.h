@@ -0,0 +1,53 @@
+#pragma once
+
+#include "raylib.h"
+#include "world.h" // TileKind
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One static vertex buffer for a vertical strip of the level
+struct TilemapChunk {
+    Rectangle area;   // World-space bounds of every quad in the mesh, for culling
+    Mesh mesh;
+    int key;          // Which platform set it was built from (world chunk index when streaming)
+};
+
+// Static tile renderer: every ground/platform/stair tile is baked into GPU
+// meshes once after level generation and drawn with one call per visible chunk,
+// instead of one DrawTexture per Platform every frame.
+struct TilemapRenderer {
+    Texture2D texture;   // Tile texture or atlas (not owned)
+    Rectangle sources[TILE_KIND_COUNT]; // Tile image per TileKind inside texture, in pixels
+    Material material;
+    std::vector<TilemapChunk> chunks;
+    float chunkWidth;    // World width covered by one chunk
+    uint32_t worldRevision; // World::revision the meshes were last synced to (0: none, forces a sync)
+};
+
+// Release any meshes and set the tile texture, with source used for every tile kind; no platforms yet
+void InitTilemap(TilemapRenderer& tilemap, Texture2D texture, Rectangle source, float chunkWidth = 1024.0f);
+
+// Draw one kind of tile with its own image (affects meshes built afterwards)
+void SetTilemapTileSource(TilemapRenderer& tilemap, TileKind kind, Rectangle source);
+
+// Add meshes for count platforms, tagged with key, or remove every mesh with key.
+// tiles gives each platform's TileKind (nullptr = all ground).
+void AddTilemapPlatforms(TilemapRenderer& tilemap, const Platform* platforms, const uint8_t* tiles, size_t count,
+                         int key);
+void RemoveTilemapPlatforms(TilemapRenderer& tilemap, int key);
+
+// Free every mesh but keep the texture and material, e.g. when a new level replaces the world's.
+// The next sync rebuilds whatever chunks are resident.
+void ClearTilemapPlatforms(TilemapRenderer& tilemap);
+
+// Match the meshes to a copy of the world's resident chunks (a render-thread
+// snapshot): build newly loaded chunks and free evicted ones. Does nothing
+// unless worldRevision changed since the last call.
+void SyncTilemapWithChunks(TilemapRenderer& tilemap, const std::vector<WorldChunk>& chunks, uint32_t worldRevision);
+
+// Draw the chunks overlapping view (world coordinates); call between BeginDrawing/EndDrawing
+void DrawTilemap(const TilemapRenderer& tilemap, Rectangle view);
+
+// Release the meshes and material (the tile texture stays loaded)
+void UnloadTilemap(TilemapRenderer& tilemap);
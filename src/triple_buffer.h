@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-off of the latest value from one producer thread to one
+// consumer thread. The producer fills the back slot and publishes it; the
+// consumer takes the newest published slot. Each side owns one slot and the
+// third sits between them, swapped with a single atomic exchange, so neither
+// side ever waits or sees a half-written value. Values the consumer was too
+// slow to take are dropped. Slots are reused, so filling one by assignment
+// stops allocating once its vectors have grown.
+template <typename T>
+struct TripleBuffer {
+    T slots[3];
+    uint8_t back;                // Producer's slot
+    uint8_t front;               // Consumer's slot
+    std::atomic<uint8_t> middle; // Slot in between, plus tripleBufferFresh if the consumer has not taken it
+};
+
+const uint8_t tripleBufferFresh = 0x80;
+const uint8_t tripleBufferIndex = 0x03;
+static_assert(std::atomic<uint8_t>::is_always_lock_free, "TripleBuffer needs lock-free byte atomics");
+
+// Call before either thread uses the buffer
+template <typename T>
+void InitTripleBuffer(TripleBuffer<T>& buffer) {
+    buffer.back = 0;
+    buffer.middle.store(1, std::memory_order_relaxed);
+    buffer.front = 2;
+}
+
+// Producer: the slot to fill next
+template <typename T>
+T& GetTripleBufferBack(TripleBuffer<T>& buffer) {
+    return buffer.slots[buffer.back];
+}
+
+// Producer: make the back slot the newest value and get a new back slot
+template <typename T>
+void PublishTripleBuffer(TripleBuffer<T>& buffer) {
+    uint8_t previous = buffer.middle.exchange(buffer.back | tripleBufferFresh, std::memory_order_acq_rel);
+    buffer.back = previous & tripleBufferIndex;
+}
+
+// Consumer: switch the front slot to the newest published value; returns false
+// (keeping the current front) if nothing was published since the last call
+template <typename T>
+bool ConsumeTripleBuffer(TripleBuffer<T>& buffer) {
+    if (!(buffer.middle.load(std::memory_order_acquire) & tripleBufferFresh)) return false;
+    uint8_t previous = buffer.middle.exchange(buffer.front, std::memory_order_acq_rel);
+    buffer.front = previous & tripleBufferIndex;
+    return true;
+}
+
+// Consumer: the value taken by the last successful ConsumeTripleBuffer
+template <typename T>
+const T& GetTripleBufferFront(const TripleBuffer<T>& buffer) {
+    return buffer.slots[buffer.front];
+}
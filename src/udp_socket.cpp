@@ -0,0 +1,135 @@
+#include "udp_socket.h"
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Winsock needs WSAStartup once per process before any socket call
+static bool StartSockets() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+#else
+static bool StartSockets() {
+    return true;
+}
+#endif
+
+static sockaddr_in MakeSocketAddress(const UdpAddress& address) {
+    sockaddr_in result;
+    memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.host);
+    result.sin_port = htons(address.port);
+    return result;
+}
+
+bool OpenUdpSocket(UdpSocket& udp, uint16_t port) {
+    udp = {-1, 0};
+    if (!StartSockets()) return false;
+#ifdef _WIN32
+    SOCKET handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET) return false;
+    u_long nonBlocking = 1;
+    bool configured = ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+    int handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0) return false;
+    bool configured = fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    udp.handle = static_cast<intptr_t>(handle);
+
+    sockaddr_in local = MakeSocketAddress({INADDR_ANY, port});
+    socklen_t length = sizeof(local);
+    if (!configured || bind(handle, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+        getsockname(handle, reinterpret_cast<sockaddr*>(&local), &length) != 0) {
+        CloseUdpSocket(udp);
+        return false;
+    }
+    udp.port = ntohs(local.sin_port);
+    return true;
+}
+
+void CloseUdpSocket(UdpSocket& udp) {
+    if (udp.handle == -1) return;
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(udp.handle));
+#else
+    close(static_cast<int>(udp.handle));
+#endif
+    udp = {-1, 0};
+}
+
+bool ResolveUdpAddress(const std::string& host, uint16_t port, UdpAddress& address) {
+    if (!StartSockets()) return false;
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || found == nullptr) return false;
+    address.host = ntohl(reinterpret_cast<sockaddr_in*>(found->ai_addr)->sin_addr.s_addr);
+    address.port = port;
+    freeaddrinfo(found);
+    return true;
+}
+
+bool ParseUdpAddress(const std::string& text, UdpAddress& address) {
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon + 1 == text.size()) return false;
+    int port = atoi(text.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) return false;
+    return ResolveUdpAddress(text.substr(0, colon), static_cast<uint16_t>(port), address);
+}
+
+bool SendUdp(UdpSocket& udp, const UdpAddress& to, const void* data, size_t size) {
+    sockaddr_in target = MakeSocketAddress(to);
+#ifdef _WIN32
+    int sent = sendto(static_cast<SOCKET>(udp.handle), static_cast<const char*>(data), static_cast<int>(size), 0,
+                      reinterpret_cast<sockaddr*>(&target), sizeof(target));
+#else
+    ssize_t sent = sendto(static_cast<int>(udp.handle), data, size, 0, reinterpret_cast<sockaddr*>(&target),
+                          sizeof(target));
+#endif
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+int ReceiveUdp(UdpSocket& udp, void* buffer, size_t capacity, UdpAddress& from) {
+    sockaddr_in source;
+    socklen_t length = sizeof(source);
+#ifdef _WIN32
+    int received = recvfrom(static_cast<SOCKET>(udp.handle), static_cast<char*>(buffer), static_cast<int>(capacity),
+                            0, reinterpret_cast<sockaddr*>(&source), &length);
+    if (received < 0) {
+        int error = WSAGetLastError();
+        // A datagram bounced off a closed port shows up as a reset; it is not a socket failure
+        return (error == WSAEWOULDBLOCK || error == WSAECONNRESET || error == WSAEMSGSIZE) ? 0 : -1;
+    }
+#else
+    ssize_t received = recvfrom(static_cast<int>(udp.handle), buffer, capacity, 0,
+                                reinterpret_cast<sockaddr*>(&source), &length);
+    if (received < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED || errno == EINTR) ? 0 : -1;
+    }
+#endif
+    from.host = ntohl(source.sin_addr.s_addr);
+    from.port = ntohs(source.sin_port);
+    return static_cast<int>(received);
+}
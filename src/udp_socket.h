@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// IPv4 address and port, both in host byte order
+struct UdpAddress {
+    uint32_t host;
+    uint16_t port;
+};
+
+// Non-blocking UDP socket (BSD sockets or Winsock)
+struct UdpSocket {
+    intptr_t handle; // -1 when closed
+    uint16_t port;   // Bound local port
+};
+
+// Bind to port on every interface (0 picks a free port); false on failure
+bool OpenUdpSocket(UdpSocket& socket, uint16_t port);
+
+void CloseUdpSocket(UdpSocket& socket);
+
+// Look up an IPv4 address ("127.0.0.1", "localhost", a host name)
+bool ResolveUdpAddress(const std::string& host, uint16_t port, UdpAddress& address);
+
+// Parse "host:port"
+bool ParseUdpAddress(const std::string& text, UdpAddress& address);
+
+bool SendUdp(UdpSocket& socket, const UdpAddress& to, const void* data, size_t size);
+
+// Bytes of the next waiting datagram (copied into buffer), 0 if none is waiting, -1 on error
+int ReceiveUdp(UdpSocket& socket, void* buffer, size_t capacity, UdpAddress& from);
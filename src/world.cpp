@@ -0,0 +1,122 @@
+#include "world.h"
+#include "game.h"
+#include "level_generator.h"
+#include <algorithm>
+#include <cmath>
+
+void BakeLevel(const Level& level, BakedLevel& baked) {
+    int chunkCount = std::max(1, level.chunkCount);
+    float chunkWidth = static_cast<float>(worldChunkTiles * tileSize);
+
+    // Cut every platform at the chunk borders it crosses, then bucket the pieces
+    // by chunk with a counting pass so each chunk's slice is contiguous
+    auto firstChunk = [&](const Rectangle& rect) {
+        return std::max(0, std::min(chunkCount - 1, static_cast<int>(std::floor(rect.x / chunkWidth))));
+    };
+    auto lastChunk = [&](const Rectangle& rect) {
+        int last = static_cast<int>(std::ceil((rect.x + rect.width) / chunkWidth)) - 1;
+        return std::max(0, std::min(chunkCount - 1, last));
+    };
+    baked.chunkStart.assign(chunkCount + 1, 0);
+    for (const auto& platform : level.platforms) {
+        for (int c = firstChunk(platform.rect); c <= lastChunk(platform.rect); c++) baked.chunkStart[c + 1]++;
+    }
+    for (int c = 0; c < chunkCount; c++) baked.chunkStart[c + 1] += baked.chunkStart[c];
+
+    baked.platforms.resize(baked.chunkStart[chunkCount]);
+    baked.tiles.resize(baked.chunkStart[chunkCount]);
+    std::vector<uint32_t> fill(baked.chunkStart.begin(), baked.chunkStart.end() - 1);
+    for (size_t i = 0; i < level.platforms.size(); i++) {
+        const Rectangle& rect = level.platforms[i].rect;
+        uint8_t tile = i < level.tiles.size() ? level.tiles[i] : static_cast<uint8_t>(TILE_GROUND);
+        int first = firstChunk(rect), last = lastChunk(rect);
+        for (int c = first; c <= last; c++) {
+            // The level's first and last chunks keep anything sticking out of the level
+            float left = c == first ? rect.x : c * chunkWidth;
+            float right = c == last ? rect.x + rect.width : (c + 1) * chunkWidth;
+            baked.tiles[fill[c]] = tile;
+            baked.platforms[fill[c]++] = {{left, rect.y, right - left, rect.height}};
+        }
+    }
+    baked.batZones = level.batZones;
+
+    LevelView& view = baked.view;
+    view.seed = level.seed;
+    view.chunkCount = chunkCount;
+    view.width = level.width;
+    view.playerSpawn = level.playerSpawn;
+    view.flagPosition = level.flagPosition;
+    view.platforms = baked.platforms.data();
+    view.tiles = baked.tiles.data();
+    view.chunkStart = baked.chunkStart.data();
+    view.platformCount = static_cast<int>(baked.platforms.size());
+    view.batZones = baked.batZones.data();
+    view.batZoneCount = static_cast<int>(baked.batZones.size());
+}
+
+void InitWorld(World& world, const LevelView& level) {
+    world.seed = level.seed;
+    world.chunkCount = std::max(1, level.chunkCount);
+    world.chunkWidth = static_cast<float>(worldChunkTiles * tileSize);
+    world.width = world.chunkCount * world.chunkWidth;
+    world.flagPosition = level.flagPosition;
+    world.batZones.assign(level.batZones, level.batZones + level.batZoneCount);
+    world.levelPlatforms.assign(level.platforms, level.platforms + level.platformCount);
+    world.levelTiles.assign(level.tiles, level.tiles + level.platformCount);
+    world.chunkStart.assign(level.chunkStart, level.chunkStart + world.chunkCount + 1);
+    for (auto& chunk : world.chunks) {
+        world.spare.push_back(std::move(chunk));
+    }
+    world.chunks.clear();
+    world.revision++;
+}
+
+void LoadWorldChunk(const World& world, int index, WorldChunk& chunk) {
+    uint32_t first = world.chunkStart[index], last = world.chunkStart[index + 1];
+    chunk.index = index;
+    chunk.platforms.assign(world.levelPlatforms.begin() + first, world.levelPlatforms.begin() + last);
+    chunk.tiles.assign(world.levelTiles.begin() + first, world.levelTiles.begin() + last);
+}
+
+bool StreamWorld(World& world, float viewX, float viewWidth) {
+    int first = static_cast<int>(std::floor(viewX / world.chunkWidth)) - worldChunksBehind;
+    int last = static_cast<int>(std::floor((viewX + viewWidth) / world.chunkWidth)) + worldChunksAhead;
+    first = std::max(first, 0);
+    last = std::min(last, world.chunkCount - 1);
+    if (!world.chunks.empty() && world.chunks.front().index == first && world.chunks.back().index == last) {
+        return false;
+    }
+
+    // Evict everything outside [first, last]
+    for (size_t i = world.chunks.size(); i-- > 0;) {
+        if (world.chunks[i].index < first || world.chunks[i].index > last) {
+            world.spare.push_back(std::move(world.chunks[i]));
+            world.chunks.erase(world.chunks.begin() + i);
+        }
+    }
+
+    // Load the missing ones into recycled chunks
+    for (int index = first; index <= last; index++) {
+        bool resident = std::any_of(world.chunks.begin(), world.chunks.end(),
+                                    [index](const WorldChunk& chunk) { return chunk.index == index; });
+        if (resident) continue;
+        WorldChunk chunk;
+        if (!world.spare.empty()) {
+            chunk = std::move(world.spare.back());
+            world.spare.pop_back();
+        }
+        LoadWorldChunk(world, index, chunk);
+        world.chunks.push_back(std::move(chunk));
+    }
+    std::sort(world.chunks.begin(), world.chunks.end(),
+              [](const WorldChunk& a, const WorldChunk& b) { return a.index < b.index; });
+    world.revision++;
+    return true;
+}
+
+void CollectWorldPlatforms(const World& world, std::vector<Platform>& out) {
+    out.clear();
+    for (const auto& chunk : world.chunks) {
+        out.insert(out.end(), chunk.platforms.begin(), chunk.platforms.end());
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "raylib.h" // Vector2 / Rectangle
+#include <cstdint>
+#include <vector>
+
+// Platform/ground structure
+struct Platform {
+    Rectangle rect;
+};
+
+// Level length is measured in fixed-width chunks of worldChunkTiles tiles
+const int worldChunkTiles = 20;   // One screen wide
+const int worldChunksBehind = 1;  // Chunks kept loaded left of the view
+const int worldChunksAhead = 1;   // Chunks loaded right of the view before it gets there
+const int defaultLevelChunks = 8;
+
+// What a platform is drawn as
+enum TileKind : uint8_t {
+    TILE_GROUND, // Ground runs, from their top down to the bottom of the screen
+    TILE_LEDGE,  // Floating platforms
+    TILE_STAIR,  // The staircase up to the flag
+    TILE_KIND_COUNT
+};
+
+// A level in the form the World streams from: platforms cut at chunk borders
+// and grouped by chunk (CSR layout: chunkStart offsets into platforms). Does
+// not own its arrays; they live in a BakedLevel or a mapped level file.
+struct LevelView {
+    uint64_t seed;
+    int chunkCount;
+    float width;
+    Vector2 playerSpawn;           // Where the player's feet start
+    Vector2 flagPosition;
+    const Platform* platforms;
+    const uint8_t* tiles;          // TileKind per platform
+    const uint32_t* chunkStart;    // chunkCount + 1 offsets into platforms
+    int platformCount;
+    const Rectangle* batZones;     // In ascending x order
+    int batZoneCount;
+};
+
+// Owning storage for a baked level
+struct BakedLevel {
+    LevelView view;                // Points into the vectors below
+    std::vector<Platform> platforms;
+    std::vector<uint8_t> tiles;
+    std::vector<uint32_t> chunkStart;
+    std::vector<Rectangle> batZones;
+};
+
+struct Level;
+
+// Cut level's platforms at the chunk borders they cross and group them by chunk
+void BakeLevel(const Level& level, BakedLevel& baked);
+
+// One chunk's platforms, copied out of the level when the chunk is loaded
+struct WorldChunk {
+    int index;
+    std::vector<Platform> platforms;
+    std::vector<uint8_t> tiles;
+};
+
+// Streaming side-scrolling level: only the chunks around the view are resident,
+// so per-tick collision cost stays constant for any level length. The baked
+// level is copied in once, so a World never points into a file or another level;
+// that copy (levelPlatforms, levelTiles) still grows with level length.
+struct World {
+    uint64_t seed;
+    int chunkCount;
+    float chunkWidth;
+    float width;                          // chunkCount * chunkWidth
+    Vector2 flagPosition;                 // On top of the staircase in the last chunk
+    std::vector<Rectangle> batZones;      // In ascending x order
+    std::vector<Platform> levelPlatforms; // Every platform, grouped by chunk
+    std::vector<uint8_t> levelTiles;      // TileKind per levelPlatforms entry
+    std::vector<uint32_t> chunkStart;     // chunkCount + 1 offsets into levelPlatforms
+    std::vector<WorldChunk> chunks;       // Resident chunks in ascending index order
+    std::vector<WorldChunk> spare;        // Evicted chunks, kept so reloading reuses their memory
+    uint32_t revision = 0;                // Bumped whenever chunks are loaded or evicted (so >= 1 after InitWorld)
+};
+
+// Set up streaming over a baked level with nothing resident yet. Only copies
+// arrays, so switching levels costs microseconds.
+void InitWorld(World& world, const LevelView& level);
+
+// Copy chunk index's platforms and tiles (in world coordinates) into chunk
+void LoadWorldChunk(const World& world, int index, WorldChunk& chunk);
+
+// Load the chunks overlapping [viewX, viewX + viewWidth] plus the margins and
+// evict the rest. Returns true if the resident set changed.
+bool StreamWorld(World& world, float viewX, float viewWidth);
+
+// Concatenate the resident chunks' platforms, in chunk order
+void CollectWorldPlatforms(const World& world, std::vector<Platform>& out);
@@ -0,0 +1,64 @@
+// Difficulty tuning harness: the bot plays many independent headless games on
+// every core and reports how often and how fast it reaches the flag and how
+// often bats hit it. Re-run after changing batSpeed or the jump constants.
+//   findtreasure_bot [--games N] [--seed S] [--chunks N] [--threads N] [--max-seconds N]
+//                    [--horizon N] [--replan N] [--csv results.csv]
+#include "bot.h"
+#include "parallel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static bool WriteResultsCsv(const char* path, const std::vector<BotGameResult>& results) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "seed,reached_flag,seconds,bat_hits\n");
+    for (const BotGameResult& result : results) {
+        fprintf(file, "%llu,%d,%.3f,%d\n", static_cast<unsigned long long>(result.seed), result.reachedFlag ? 1 : 0,
+                static_cast<float>(result.ticks) / ticksPerSecond, result.batHits);
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    BotRunSettings settings = DefaultBotRunSettings();
+    const char* csvPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) settings.games = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) settings.firstSeed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--chunks") == 0 && i + 1 < argc) settings.levelChunks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) settings.threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) settings.maxTicks = atoi(argv[++i]) * ticksPerSecond;
+        else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc) settings.bot.horizonTicks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--replan") == 0 && i + 1 < argc) settings.bot.replanTicks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: findtreasure_bot [--games N] [--seed S] [--chunks N] [--threads N] "
+                            "[--max-seconds N] [--horizon N] [--replan N] [--csv results.csv]\n");
+            return 2;
+        }
+    }
+
+    // The constants under test are compiled in; print them so runs can be compared
+    printf("batSpeed=%.2f jumpForce=%.2f jumpHoldForce=%.2f maxJumpHoldTime=%.0f gravity=%.2f "
+           "airControlFactor=%.2f\n", batSpeed, jumpForce, jumpHoldForce, maxJumpHoldTime, gravity, airControlFactor);
+
+    std::vector<BotGameResult> results;
+    auto start = std::chrono::steady_clock::now();
+    RunBotGames(settings, results);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BotRunSummary summary;
+    SummarizeBotGames(results, summary);
+    printf("games=%d chunks=%d threads=%d time=%.2fs (%.0f games/s)\n", summary.games, settings.levelChunks,
+           settings.threadCount > 0 ? settings.threadCount : DefaultThreadCount(), seconds, summary.games / seconds);
+    printf("winRate=%.1f%% timeToFlag mean=%.1fs p50=%.1fs p90=%.1fs batHits=%.2f/game\n", summary.winRate * 100.0f,
+           summary.meanSecondsToFlag, summary.p50SecondsToFlag, summary.p90SecondsToFlag, summary.meanBatHits);
+
+    if (csvPath && !WriteResultsCsv(csvPath, results)) {
+        fprintf(stderr, "Failed to write %s\n", csvPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Level compiler: converts a hand-edited text level set into the binary
+// format the game maps in place, refusing levels whose flag cannot be reached.
+//   findtreasure_levelc levels.txt levels.ftlv [--force]
+#include "level_file.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    bool force = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--force") == 0) force = true;
+        else if (!inPath) inPath = argv[i];
+        else outPath = argv[i];
+    }
+    if (!inPath || !outPath) {
+        fprintf(stderr, "usage: findtreasure_levelc <levels.txt> <levels.ftlv> [--force]\n");
+        return 2;
+    }
+
+    std::vector<Level> levels;
+    if (!LoadLevelsText(inPath, levels)) return 2;
+
+    // Hand edits are the likeliest way to ship an unsolvable level
+    LevelAnalyzer analyzer;
+    LevelAnalysis analysis;
+    int unsolvable = 0;
+    for (size_t i = 0; i < levels.size(); i++) {
+        const Level& level = levels[i];
+        if (!AnalyzeLevel(analyzer, level.platforms, level.playerSpawn, level.flagPosition, defaultPlayerSize,
+                          analysis)) {
+            fprintf(stderr, "%s: level %zu (seed %llu): flag is unreachable (%d of %zu platforms reachable)\n",
+                    inPath, i, static_cast<unsigned long long>(level.seed), analysis.reachableCount,
+                    level.platforms.size());
+            unsolvable++;
+        }
+    }
+    if (unsolvable > 0 && !force) {
+        fprintf(stderr, "%d unsolvable level(s); nothing written (--force to write anyway)\n", unsolvable);
+        return 1;
+    }
+
+    if (!SaveLevelFile(outPath, levels)) {
+        fprintf(stderr, "Failed to write %s\n", outPath);
+        return 1;
+    }
+
+    // Read it back the way the game does and time a level switch
+    LevelFile file;
+    if (!OpenLevelFile(file, outPath)) return 1;
+    GameState state;
+    LevelView view;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < file.levelCount; i++) {
+        GetLevelView(file, i, view);
+        InitGame(state, view, defaultPlayerSpriteSize, defaultBatFrameSize);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %d levels, %zu bytes, %.1f us per level switch\n", outPath, file.levelCount, file.mapped.size,
+           file.levelCount > 0 ? us / file.levelCount : 0.0);
+    CloseLevelFile(file);
+    return 0;
+}
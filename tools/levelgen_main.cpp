@@ -0,0 +1,65 @@
+// Batch level generation for pre-baking level sets: generates and validates
+// levels for consecutive seeds on every core and optionally writes them out.
+//   findtreasure_levelgen [--count N] [--seed S] [--chunks N] [--threads N] [--simulate]
+//                         [--out levels.txt] [--binary levels.ftlv]
+// --simulate also plays every level's route through the real physics (slower).
+#include "level_file.h"
+#include "parallel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    int count = 1000;
+    uint64_t firstSeed = 1;
+    int chunks = defaultLevelChunks;
+    int threads = 0;
+    bool simulate = false;
+    const char* outPath = nullptr;
+    const char* binaryPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) firstSeed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--chunks") == 0 && i + 1 < argc) chunks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--simulate") == 0) simulate = true;
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (strcmp(argv[i], "--binary") == 0 && i + 1 < argc) binaryPath = argv[++i];
+        else {
+            fprintf(stderr, "usage: findtreasure_levelgen [--count N] [--seed S] [--chunks N] [--threads N] "
+                            "[--simulate] [--out levels.txt] [--binary levels.ftlv]\n");
+            return 2;
+        }
+    }
+
+    std::vector<Level> levels;
+    LevelSettings settings = DefaultLevelSettings(chunks);
+    settings.simulateRoute = simulate;
+    auto start = std::chrono::steady_clock::now();
+    int failed = GenerateLevels(levels, firstSeed, count, settings, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long attempts = 0, platforms = 0, pathLength = 0;
+    for (const Level& level : levels) {
+        attempts += level.attempts;
+        platforms += static_cast<long>(level.platforms.size());
+        pathLength += level.pathLength;
+    }
+    printf("levels=%d chunks=%d threads=%d time=%.3fs (%.0f levels/s)\n", count, settings.chunkCount,
+           threads > 0 ? threads : DefaultThreadCount(), seconds, count / seconds);
+    double perLevel = count > 0 ? 1.0 / count : 0.0;
+    printf("failed=%d avgAttempts=%.2f avgPlatforms=%.1f avgPathLength=%.1f\n", failed, attempts * perLevel,
+           platforms * perLevel, pathLength * perLevel);
+
+    if (outPath && !SaveLevelsText(outPath, levels)) {
+        fprintf(stderr, "Failed to write %s\n", outPath);
+        return 1;
+    }
+    if (binaryPath && !SaveLevelFile(binaryPath, levels)) {
+        fprintf(stderr, "Failed to write %s\n", binaryPath);
+        return 1;
+    }
+    // Failed seeds still get the plain fallback layout, but a baked set should not contain any
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Loopback test of the versus rollback netcode: two peers in one process, each
+// on its own thread and UDP port, race the same level with the bot playing
+// both sides, under simulated latency, jitter and loss. Reports rollbacks and
+// timings per peer and checks that both ended on the same state.
+//   findtreasure_netplay [--seed S] [--seconds N] [--latency ms] [--jitter ms] [--loss fraction] [--port P]
+#include "bot.h"
+#include "fixed_timestep.h"
+#include "netplay.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+struct PeerRun {
+    int player;
+    uint16_t port;
+    uint16_t remotePort;
+    NetConditions conditions;
+    uint64_t seed;
+    int64_t endTick;
+
+    // Results
+    bool ok;
+    uint64_t finalHash;
+    int winner;
+    int rollbacks;
+    int64_t resimulatedTicks;
+    int maxRollbackTicks;
+    int64_t stalledTicks;
+    int64_t waitedTicks;
+    int64_t packetsSent, packetsReceived, packetsDropped;
+    double meanTickUs;       // AdvanceRollbackSession, rollbacks included
+    double maxTickUs;
+    double snapshotUs;       // Copying one VersusState into the save ring
+};
+
+static double NowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void RunPeer(PeerRun& run) {
+    run.ok = false;
+    std::unique_ptr<RollbackSession> sessionStorage(new RollbackSession());
+    RollbackSession& session = *sessionStorage;
+    BeginRollbackSession(session, run.player, run.seed);
+
+    NetPeer peer;
+    if (!OpenNetPeer(peer, run.port, {0x7f000001, run.remotePort}, run.conditions, run.seed)) {
+        fprintf(stderr, "player %d: cannot bind UDP port %d\n", run.player + 1, run.port);
+        return;
+    }
+    Bot bot;
+    InitBot(bot, DefaultBotSettings());
+
+    FixedTimestep timestep;
+    InitFixedTimestep(timestep, ticksPerSecond, 5);
+    double last = NowSeconds();
+    double tickSeconds = 0;
+    int64_t timedTicks = 0;
+    run.maxTickUs = 0;
+    run.waitedTicks = 0;
+    while (static_cast<int64_t>(session.state.tick) < run.endTick) {
+        double now = NowSeconds();
+        int ticks = AdvanceFixedTimestep(timestep, now - last);
+        last = now;
+        for (int t = 0; t < ticks && static_cast<int64_t>(session.state.tick) < run.endTick; t++) {
+            PollNetPeer(peer, session, now);
+            if (ShouldWaitForPeer(peer, session)) {
+                run.waitedTicks++;
+            } else if (!CanAdvanceRollbackSession(session)) {
+                session.stalledTicks++;
+            } else {
+                InputFrame input = GetBotInput(bot, session.state.games[run.player]);
+                double start = NowSeconds();
+                AdvanceRollbackSession(session, input);
+                double seconds = NowSeconds() - start;
+                tickSeconds += seconds;
+                timedTicks++;
+                run.maxTickUs = std::max(run.maxTickUs, seconds * 1e6);
+            }
+            SendNetInputs(peer, session, now);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Keep talking until each side has the other's input for every tick, then settle any last rollback
+    double deadline = NowSeconds() + 5.0;
+    while ((session.remoteConfirmed < run.endTick - 1 || session.localAcked < run.endTick - 1) && NowSeconds() < deadline) {
+        double now = NowSeconds();
+        PollNetPeer(peer, session, now);
+        SendNetInputs(peer, session, now);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // The peer may still be waiting for our acknowledgement; answer for a little longer
+    for (int i = 0; i < 50; i++) {
+        double now = NowSeconds();
+        PollNetPeer(peer, session, now);
+        SendNetInputs(peer, session, now);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ApplyRollback(session);
+
+    // What saving one tick's state costs
+    const int copies = 200;
+    double start = NowSeconds();
+    for (int i = 0; i < copies; i++) session.saved[i % (rollbackMaxTicks + 1)] = session.state;
+    run.snapshotUs = (NowSeconds() - start) * 1e6 / copies;
+
+    run.ok = session.remoteConfirmed >= run.endTick - 1;
+    run.finalHash = HashVersusState(session.state);
+    run.winner = session.state.winner;
+    run.rollbacks = session.rollbacks;
+    run.resimulatedTicks = session.resimulatedTicks;
+    run.maxRollbackTicks = session.maxRollbackTicks;
+    run.stalledTicks = session.stalledTicks;
+    run.packetsSent = peer.packetsSent;
+    run.packetsReceived = peer.packetsReceived;
+    run.packetsDropped = peer.packetsDropped;
+    run.meanTickUs = timedTicks > 0 ? tickSeconds * 1e6 / timedTicks : 0;
+    CloseNetPeer(peer);
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = 1;
+    int seconds = 45;
+    NetConditions conditions = {50, 0, 0.0f}; // 100 ms round trip
+    int port = 47800;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) conditions.latencyMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) conditions.jitterMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc) conditions.loss = static_cast<float>(atof(argv[++i]));
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) port = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: findtreasure_netplay [--seed S] [--seconds N] [--latency ms] [--jitter ms] "
+                            "[--loss fraction] [--port P]\n");
+            return 2;
+        }
+    }
+
+    printf("seed=%llu seconds=%d latency=%dms (+%dms jitter) loss=%.1f%% rollbackMaxTicks=%d\n",
+           static_cast<unsigned long long>(seed), seconds, conditions.latencyMs, conditions.jitterMs,
+           conditions.loss * 100.0f, rollbackMaxTicks);
+    PeerRun runs[2];
+    for (int p = 0; p < 2; p++) {
+        runs[p] = {};
+        runs[p].player = p;
+        runs[p].port = static_cast<uint16_t>(port + p);
+        runs[p].remotePort = static_cast<uint16_t>(port + 1 - p);
+        runs[p].conditions = conditions;
+        runs[p].seed = seed;
+        runs[p].endTick = static_cast<int64_t>(seconds) * ticksPerSecond;
+    }
+    std::thread second(RunPeer, std::ref(runs[1]));
+    RunPeer(runs[0]);
+    second.join();
+
+    for (const PeerRun& run : runs) {
+        printf("player %d: rollbacks=%d resimulated=%lld maxDepth=%d stalled=%lld waited=%lld "
+               "packets sent=%lld received=%lld dropped=%lld\n",
+               run.player + 1, run.rollbacks, static_cast<long long>(run.resimulatedTicks), run.maxRollbackTicks,
+               static_cast<long long>(run.stalledTicks), static_cast<long long>(run.waitedTicks),
+               static_cast<long long>(run.packetsSent), static_cast<long long>(run.packetsReceived),
+               static_cast<long long>(run.packetsDropped));
+        printf("          tick mean=%.1fus max=%.1fus snapshot=%.2fus local input delay=0 ticks\n", run.meanTickUs,
+               run.maxTickUs, run.snapshotUs);
+    }
+    const char* results[] = {"player 1 wins", "player 2 wins", "draw"};
+    bool inSync = runs[0].ok && runs[1].ok && runs[0].finalHash == runs[1].finalHash;
+    printf("result: %s, peers %s\n", runs[0].winner >= 0 ? results[runs[0].winner] : "no winner yet",
+           inSync ? "in sync" : "DESYNC or incomplete");
+    return inSync ? 0 : 1;
+}
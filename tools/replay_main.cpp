@@ -0,0 +1,57 @@
+// Headless replay: re-simulates a recording as fast as possible and checks the
+// final state hash against the one stored when it was recorded.
+//   findtreasure_replay run.ftrec [--repeat N]
+#include "input_recording.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    int repeats = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeats = atoi(argv[++i]);
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "usage: findtreasure_replay <recording> [--repeat N]\n");
+        return 2;
+    }
+
+    InputRecording recording;
+    if (!LoadInputRecording(recording, path)) return 2;
+
+    // Every repeat must land on the same hash; a mismatch between repeats means
+    // the sim reads something that is not in GameState
+    GameState state;
+    uint64_t hash = 0;
+    bool stable = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        ReplayInputRecording(state, recording);
+        uint64_t runHash = HashGameState(state);
+        if (r > 0 && runHash != hash) stable = false;
+        hash = runHash;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double ticks = static_cast<double>(recording.buttons.size()) * repeats;
+    printf("ticks=%zu seed=%u score bat=%d player=%d levelComplete=%d\n", recording.buttons.size(),
+           recording.seed, state.score.bat, state.score.player, state.levelComplete ? 1 : 0);
+    printf("replayed %.0f ticks in %.3f ms (%.0f ticks/s, %.0fx realtime)\n", ticks, seconds * 1000.0,
+           ticks / seconds, ticks / seconds / 60.0);
+    printf("hash=%016llx recorded=%016llx\n", static_cast<unsigned long long>(hash),
+           static_cast<unsigned long long>(recording.finalHash));
+
+    if (!stable) {
+        printf("DESYNC: repeated replays produced different hashes\n");
+        return 1;
+    }
+    if (recording.finalHash != 0 && hash != recording.finalHash) {
+        printf("DESYNC: final state differs from the recorded run\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}